@@ -657,11 +657,36 @@ McSim::McSim(PthreadTimingSimulator * pts_)
     assert(num_mcs == num_dirs);
     }
   }
+
+  // simulate the memory controllers on worker threads, in windows of half
+  // the shortest MC-to-directory latency
+  if (pts->get_param_str("pts.geq.pdes") == "true")
+  {
+    bool pdes_capable = (mcs.empty() == false);
+    uint64_t lookahead = ~(uint64_t)0;
+    vector<Component *> mc_comps;
+    for (uint32_t i = 0; i < mcs.size(); i++)
+    {
+      pdes_capable = pdes_capable && mcs[i]->pdes_capable();
+      lookahead    = min(lookahead, (uint64_t)mcs[i]->min_mc_to_dir_t() / 2);
+      mc_comps.push_back(mcs[i]);
+    }
+
+    if (pdes_capable == false || lookahead == 0)
+    {
+      cout << "  -- pts.geq.pdes : unsupported configuration, simulating serially" << endl;
+    }
+    else
+    {
+      global_q->start_pdes(mc_comps, lookahead, pts->get_param_uint64("pts.geq.pdes_threads", mcs.size()));
+    }
+  }
 }
 
 
 McSim::~McSim()
 {
+  global_q->stop_pdes();
   for (vector<Hthread *>::iterator iter = hthreads.begin(); iter != hthreads.end(); ++iter)
   {
     delete (*iter);
@@ -718,7 +743,7 @@ pair<uint32_t, uint64_t> McSim::resume_simulation(bool must_switch)
   pair<uint32_t, uint64_t> ret_val;  // <thread_id, time>
 
   if (/*must_switch == true &&*/
-      global_q->event_queue.begin() == global_q->event_queue.end())
+      global_q->empty() == true)
   {
     bool any_resumable_thread = false;
     if (use_o3core == true)
@@ -845,6 +870,7 @@ pair<uint32_t, uint64_t> McSim::resume_simulation(bool must_switch)
     uint64_t num_t_pred_hit = 0;
     uint64_t num_t_pred_miss = 0;
 
+    global_q->sync_pdes();
     for (unsigned int i = 0; i < mcs.size(); i++)
     {
       num_used_pages += mcs[i]->os_page_acc_dist_curr.size();
@@ -203,7 +203,7 @@ void CacheL1::add_req_event(
     event_time += process_interval - event_time%process_interval;
   }*/
   geq->add_event(event_time, this);
-  req_event.insert(pair<uint64_t, LocalQueueElement *>(event_time, local_event));
+  req_event.push(event_time, local_event);
 }
 
 
@@ -217,7 +217,7 @@ void CacheL1::add_rep_event(
     event_time += process_interval - event_time%process_interval;
   }*/
   geq->add_event(event_time, this);
-  rep_event.insert(pair<uint64_t, LocalQueueElement *>(event_time, local_event));
+  rep_event.push(event_time, local_event);
 }
 
 
@@ -248,8 +248,6 @@ void CacheL1::show_state(uint64_t address)
 
 uint32_t CacheL1::process_event(uint64_t curr_time)
 {
-  multimap<uint64_t, LocalQueueElement *>::iterator req_event_iter = req_event.begin();
-  multimap<uint64_t, LocalQueueElement *>::iterator rep_event_iter = rep_event.begin();
   //list< pair< uint64_t, coherence_state_type > >::iterator set_iter;
   pair< uint64_t, coherence_state_type > * set_iter = NULL;
 
@@ -261,26 +259,24 @@ uint32_t CacheL1::process_event(uint64_t curr_time)
     rep_lqe = rep_q.front();
     rep_q.pop();
   }
-  else if (rep_event_iter != rep_event.end() && rep_event_iter->first == curr_time)
+  else if (rep_event.ready(curr_time) == true)
   {
-    rep_lqe = rep_event_iter->second;
-    ++rep_event_iter;
+    rep_lqe = rep_event.top();
+    rep_event.pop();
   }
 
-  while (rep_event_iter != rep_event.end() && rep_event_iter->first == curr_time)
+  while (rep_event.ready(curr_time) == true)
   {
-    rep_q.push(rep_event_iter->second);
-    ++rep_event_iter;
+    rep_q.push(rep_event.top());
+    rep_event.pop();
   }
-  rep_event.erase(curr_time);
 
-  while (req_event_iter != req_event.end() && req_event_iter->first == curr_time)
+  while (req_event.ready(curr_time) == true)
   {
-    uint32_t bank = (req_event_iter->second->address >> set_lsb) % 1;//num_banks;
-    req_qs[bank].push(req_event_iter->second);
-    ++req_event_iter;
+    uint32_t bank = (req_event.top()->address >> set_lsb) % 1;//num_banks;
+    req_qs[bank].push(req_event.top());
+    req_event.pop();
   }
-  req_event.erase(curr_time);
 
   // reply events have higher priority than request events
   if (rep_lqe != NULL)
@@ -846,7 +842,7 @@ void CacheL2::add_req_event(
     event_time += process_interval - event_time%process_interval;
   }
   geq->add_event(event_time, this);
-  req_event.insert(pair<uint64_t, LocalQueueElement *>(event_time, local_event));
+  req_event.push(event_time, local_event);
 }
 
 
@@ -860,7 +856,7 @@ void CacheL2::add_rep_event(
     event_time += process_interval - event_time%process_interval;
   }
   geq->add_event(event_time, this);
-  rep_event.insert(pair<uint64_t, LocalQueueElement *>(event_time, local_event));
+  rep_event.push(event_time, local_event);
 }
 
 
@@ -892,8 +888,6 @@ void CacheL2::show_state(uint64_t address)
 
 uint32_t CacheL2::process_event(uint64_t curr_time)
 {
-  multimap<uint64_t, LocalQueueElement *>::iterator req_event_iter = req_event.begin();
-  multimap<uint64_t, LocalQueueElement *>::iterator rep_event_iter = rep_event.begin();
   //list< L2Entry >::iterator set_iter;
   uint32_t idx = 0;
   L2Entry * set_iter = NULL;
@@ -906,26 +900,24 @@ uint32_t CacheL2::process_event(uint64_t curr_time)
     rep_lqe = rep_q.front();
     rep_q.pop();
   }
-  else if (rep_event_iter != rep_event.end() && rep_event_iter->first == curr_time)
+  else if (rep_event.ready(curr_time) == true)
   {
-    rep_lqe = rep_event_iter->second;
-    ++rep_event_iter;
+    rep_lqe = rep_event.top();
+    rep_event.pop();
   }
 
-  while (rep_event_iter != rep_event.end() && rep_event_iter->first == curr_time)
+  while (rep_event.ready(curr_time) == true)
   {
-    rep_q.push(rep_event_iter->second);
-    ++rep_event_iter;
+    rep_q.push(rep_event.top());
+    rep_event.pop();
   }
-  rep_event.erase(curr_time);
 
-  while (req_event_iter != req_event.end() && req_event_iter->first == curr_time)
+  while (req_event.ready(curr_time) == true)
   {
-    uint32_t bank = (req_event_iter->second->address >> set_lsb) % num_banks;
-    req_qs[bank].push(req_event_iter->second);
-    ++req_event_iter;
+    uint32_t bank = (req_event.top()->address >> set_lsb) % num_banks;
+    req_qs[bank].push(req_event.top());
+    req_event.pop();
   }
-  req_event.erase(curr_time);
 
 
   if (rep_lqe != NULL)
@@ -1768,7 +1760,7 @@ uint32_t CacheL2::process_event(uint64_t curr_time)
 
     if (any_request == false)
     {
-      req_event_iter->second->display();  geq->display();  ASSERTX(0);
+      geq->display();  ASSERTX(0);
     }
   }
 
@@ -1896,7 +1888,7 @@ void CacheL3::add_req_event(
     event_time += process_interval - event_time % process_interval;
   }
   geq->add_event(event_time, this);
-  req_event.insert(pair<uint64_t, LocalQueueElement *>(event_time, local_event));
+  req_event.push(event_time, local_event);
 }
 
 void CacheL3::add_rep_event(
@@ -1909,7 +1901,7 @@ void CacheL3::add_rep_event(
     event_time += process_interval - event_time % process_interval;
   }
   geq->add_event(event_time, this);
-  rep_event.insert(pair<uint64_t, LocalQueueElement *>(event_time, local_event));
+  rep_event.push(event_time, local_event);
 }
 
 void CacheL3::show_state(uint64_t address)
@@ -1918,8 +1910,6 @@ void CacheL3::show_state(uint64_t address)
 
 uint32_t CacheL3::process_event(uint64_t curr_time)
 {
-  multimap<uint64_t, LocalQueueElement *>::iterator req_event_iter = req_event.begin();
-  multimap<uint64_t, LocalQueueElement *>::iterator rep_event_iter = rep_event.begin();
 
   LocalQueueElement * rep_lqe = NULL;
   LocalQueueElement * req_lqe = NULL;
@@ -1928,26 +1918,24 @@ uint32_t CacheL3::process_event(uint64_t curr_time)
     rep_lqe = rep_q.front();
     rep_q.pop();
   }
-  else if (rep_event_iter != rep_event.end() && rep_event_iter->first == curr_time)
+  else if (rep_event.ready(curr_time) == true)
   {
-    rep_lqe = rep_event_iter->second;
-    ++rep_event_iter;
+    rep_lqe = rep_event.top();
+    rep_event.pop();
   }
 
-  while (rep_event_iter != rep_event.end() && rep_event_iter->first == curr_time)
+  while (rep_event.ready(curr_time) == true)
   {
-    rep_q.push(rep_event_iter->second);
-    ++rep_event_iter;
+    rep_q.push(rep_event.top());
+    rep_event.pop();
   }
-  rep_event.erase(curr_time);
 
-  while (req_event_iter != req_event.end() && req_event_iter->first == curr_time)
+  while (req_event.ready(curr_time) == true)
   {
-    uint32_t bank = (req_event_iter->second->address >> set_lsb) % num_banks;
-    req_qs[bank].push(req_event_iter->second);
-    ++req_event_iter;
+    uint32_t bank = (req_event.top()->address >> set_lsb) % num_banks;
+    req_qs[bank].push(req_event.top());
+    req_event.pop();
   }
-  req_event.erase(curr_time);
 
   if (rep_lqe != NULL)
   {
@@ -31,9 +31,13 @@
 #include "McSim.h"
 #include "PTSComponent.h"
 #include "PTSCore.h"
+#include <algorithm>
+#include <functional>
 
 using namespace PinPthread;
 
+PushOrder PinPthread::timed_queue_order = { 0, 0 };
+
 extern ostream & operator << (ostream & output, coherence_state_type cs);
 extern ostream & operator << (ostream & output, component_type ct);
 extern ostream & operator << (ostream & output, event_type et);
@@ -42,17 +46,11 @@ extern ostream & operator << (ostream & output, event_type et);
 void LocalQueueElement::display()
 {
   cout << "  -- LQE : type = " << type << ", addr = 0x" << hex << address << dec;
-  std::stack<Component *> temp;
+  ReturnPath temp(from);
 
-  while (from.empty() == false)
-  {
-    temp.push(from.top());
-    from.pop();
-    cout << " (" << temp.top()->type << ", " << temp.top()->num << "), ";
-  }
   while (temp.empty() == false)
   {
-    from.push(temp.top());
+    cout << " (" << temp.top()->type << ", " << temp.top()->num << "), ";
     temp.pop();
   }
   cout << endl;
@@ -60,11 +58,53 @@ void LocalQueueElement::display()
 
 
 
+// freed elements keep the next free one in their first word.  slabs are
+// never returned, as the number of in-flight requests is bounded.  the list
+// is locked once the memory controllers run on worker threads (pts.geq.pdes).
+static void * lqe_free_list = NULL;
+static const uint32_t lqe_slab_size = 1024;
+static std::mutex lqe_mutex;
+static bool lqe_locked = false;
+
+void * LocalQueueElement::operator new(size_t size)
+{
+  ASSERTX((size == sizeof(LocalQueueElement)));
+  std::unique_lock<std::mutex> lock(lqe_mutex, std::defer_lock);
+  if (lqe_locked == true) lock.lock();
+  if (lqe_free_list == NULL)
+  {
+    char * slab = static_cast<char *>(::operator new(size * lqe_slab_size));
+    for (uint32_t i = 0; i < lqe_slab_size; i++)
+    {
+      *reinterpret_cast<void **>(slab + i * size) = lqe_free_list;
+      lqe_free_list = slab + i * size;
+    }
+  }
+
+  void * lqe = lqe_free_list;
+  lqe_free_list = *reinterpret_cast<void **>(lqe);
+  return lqe;
+}
+
+
+
+void LocalQueueElement::operator delete(void * lqe)
+{
+  if (lqe == NULL) return;
+  std::unique_lock<std::mutex> lock(lqe_mutex, std::defer_lock);
+  if (lqe_locked == true) lock.lock();
+  *reinterpret_cast<void **>(lqe) = lqe_free_list;
+  lqe_free_list = lqe;
+}
+
+
+
 Component::Component(
     component_type type_,
     uint32_t num_,
     McSim * mcsim_)
-:type(type_), num(num_), mcsim(mcsim_), geq(mcsim_->global_q)
+:type(type_), num(num_), mcsim(mcsim_), geq(mcsim_->global_q),
+ geq_time(~(uint64_t)0)
 {
   mcsim->comps.push_back(this);
 }
@@ -158,8 +198,18 @@ uint32_t Component::log2(uint64_t num)
 
 
 GlobalEventQueue::GlobalEventQueue(McSim * mcsim_)
-:event_queue(), curr_time(0), mcsim(mcsim_)
+:wheel(), wheel_bitmap(), wheel_time(1), num_wheel_events(0),
+ far_events(), curr_comps(), curr_idx(0), curr_comp(NULL),
+ curr_time(0), mcsim(mcsim_),
+ partitions(), dispatch_log(), workers(), num_workers(0),
+ pdes_window(0), pdes_num_busy(0), pdes_quit(false), window_open(false),
+ mc_end(0), main_end(0), lookahead(0), delivering(false), num_replies(0)
 {
+  uint32_t wheel_bits = mcsim->pts->get_param_uint64("pts.geq.wheel_bits", 12);
+  wheel_bits = (wheel_bits < 6) ? 6 : wheel_bits;
+  wheel.resize((uint64_t)1 << wheel_bits);
+  wheel_bitmap.resize(wheel.size() / 64, 0);
+  wheel_mask   = wheel.size() - 1;
   num_hthreads = mcsim->pts->get_param_uint64("pts.num_hthreads", max_hthreads);
   num_mcs      = mcsim->pts->get_param_uint64("pts.num_mcs", 2);
   interleave_base_bit = mcsim->pts->get_param_uint64("pts.mc.interleave_base_bit", 12);
@@ -175,6 +225,7 @@ GlobalEventQueue::GlobalEventQueue(McSim * mcsim_)
 GlobalEventQueue::~GlobalEventQueue()
 {
   //display();
+  stop_pdes();
 }
 
 
@@ -183,7 +234,165 @@ void GlobalEventQueue::add_event(
     uint64_t event_time,
     Component * event_target)
 {
-  event_queue[event_time].insert(event_target);
+  if (partitions.empty() == false && event_target->type == ct_memory_controller)
+  {
+    GeqPartition * part = partitions[event_target->num];
+    if (event_target->geq_time == event_time ||
+        (part->in_process == true && event_time == part->curr_time))
+    {
+      return;
+    }
+    event_target->geq_time = event_time;
+    part->times.push_back(event_time);
+    std::push_heap(part->times.begin(), part->times.end(), std::greater<uint64_t>());
+    return;
+  }
+
+  if (event_target->geq_time == event_time ||
+      (event_target == curr_comp && event_time == curr_time))
+  {
+    return;  // already there
+  }
+  event_target->geq_time = event_time;
+
+  if (event_time == curr_time)
+  {
+    std::vector<Component *>::iterator iter = std::lower_bound(
+        curr_comps.begin() + curr_idx, curr_comps.end(), event_target);
+    if (iter == curr_comps.end() || *iter != event_target)
+    {
+      curr_comps.insert(iter, event_target);
+    }
+  }
+  else if (event_time >= wheel_time && event_time - wheel_time <= wheel_mask)
+  {
+    uint64_t idx = event_time & wheel_mask;
+    wheel[idx].push_back(event_target);
+    wheel_bitmap[idx >> 6] |= ((uint64_t)1 << (idx & 63));
+    num_wheel_events++;
+  }
+  else
+  {
+    far_events.push_back(geq_event_t(event_time, event_target));
+    std::push_heap(far_events.begin(), far_events.end(), std::greater<geq_event_t>());
+  }
+}
+
+
+
+bool GlobalEventQueue::empty()
+{
+  if (curr_idx < curr_comps.size() || num_wheel_events > 0 || far_events.empty() == false)
+  {
+    return false;
+  }
+  if (partitions.empty() == false)
+  {
+    sync_pdes();
+    if (num_wheel_events > 0 || far_events.empty() == false) return false;
+    for (uint32_t i = 0; i < partitions.size(); i++)
+    {
+      if (partitions[i]->times.empty() == false) return false;
+    }
+  }
+  return true;
+}
+
+
+
+bool GlobalEventQueue::first_wheel_time(uint64_t & event_time) const
+{
+  if (num_wheel_events == 0) return false;
+
+  uint64_t start = wheel_time & wheel_mask;
+  uint32_t num_words = wheel_bitmap.size();
+  uint32_t word = start >> 6;
+  uint64_t bits = wheel_bitmap[word] & (~(uint64_t)0 << (start & 63));
+
+  for (uint32_t i = 0; i <= num_words; i++)
+  {
+    if (bits != 0)
+    {
+      uint64_t idx = ((uint64_t)word << 6) + __builtin_ctzll(bits);
+      event_time = wheel_time + ((idx - start) & wheel_mask);
+      return true;
+    }
+    word = (word + 1 == num_words) ? 0 : word + 1;
+    bits = wheel_bitmap[word];
+  }
+  ASSERTX(0);
+  return false;
+}
+
+
+
+bool GlobalEventQueue::peek_time(uint64_t & event_time) const
+{
+  bool in_wheel = first_wheel_time(event_time);
+
+  if (far_events.empty() == false &&
+      (in_wheel == false || far_events.front().first < event_time))
+  {
+    event_time = far_events.front().first;
+    return true;
+  }
+  return in_wheel;
+}
+
+
+
+bool GlobalEventQueue::next_time_slot()
+{
+  curr_comps.clear();
+  curr_idx = 0;
+
+  uint64_t next_time;
+  bool     in_wheel = first_wheel_time(next_time);
+
+  if (far_events.empty() == false &&
+      (in_wheel == false || far_events.front().first <= next_time))
+  {
+    in_wheel  = (in_wheel == true && far_events.front().first == next_time);
+    next_time = far_events.front().first;
+  }
+  else if (in_wheel == false)
+  {
+    return false;
+  }
+
+  if (in_wheel == true)
+  {
+    uint64_t idx = next_time & wheel_mask;
+    curr_comps.swap(wheel[idx]);
+    wheel_bitmap[idx >> 6] &= ~((uint64_t)1 << (idx & 63));
+    num_wheel_events -= curr_comps.size();
+  }
+  while (far_events.empty() == false && far_events.front().first == next_time)
+  {
+    curr_comps.push_back(far_events.front().second);
+    std::pop_heap(far_events.begin(), far_events.end(), std::greater<geq_event_t>());
+    far_events.pop_back();
+  }
+  std::sort(curr_comps.begin(), curr_comps.end());
+  curr_comps.erase(std::unique(curr_comps.begin(), curr_comps.end()), curr_comps.end());
+  curr_time = next_time;
+
+  if (next_time >= wheel_time)
+  {
+    // slide the wheel and move the events that now fall into it
+    wheel_time = next_time + 1;
+    while (far_events.empty() == false &&
+           far_events.front().first - wheel_time <= wheel_mask)
+    {
+      uint64_t idx = far_events.front().first & wheel_mask;
+      wheel[idx].push_back(far_events.front().second);
+      wheel_bitmap[idx >> 6] |= ((uint64_t)1 << (idx & 63));
+      num_wheel_events++;
+      std::pop_heap(far_events.begin(), far_events.end(), std::greater<geq_event_t>());
+      far_events.pop_back();
+    }
+  }
+  return true;
 }
 
 
@@ -195,30 +404,45 @@ uint32_t GlobalEventQueue::process_event()
 
   while (true)
   {
-    event_queue_t::iterator event_queue_iter = event_queue.begin();
+    if (far_events.empty() == false && far_events.front().first < curr_time &&
+        curr_idx < curr_comps.size())
+    {
+      // an event was scheduled in the past; put the rest of curr_time back
+      for (; curr_idx < curr_comps.size(); curr_idx++)
+      {
+        far_events.push_back(geq_event_t(curr_time, curr_comps[curr_idx]));
+        std::push_heap(far_events.begin(), far_events.end(), std::greater<geq_event_t>());
+      }
+    }
 
-    if (event_queue_iter != event_queue.end())
+    if (curr_idx >= curr_comps.size() && partitions.empty() == false)
     {
-      curr_time = event_queue_iter->first;
-      std::set<Component *>::iterator comp_iter = event_queue_iter->second.begin();
-      if (comp_iter == event_queue_iter->second.end())
+      uint64_t next_time;
+      if (window_open == false || peek_time(next_time) == false || next_time >= main_end)
       {
-        display();  ASSERTX(0);
+        if (next_window() == true) continue;
+        // otherwise nothing is left anywhere
       }
+    }
 
-      switch ((*comp_iter)->type)
+    if (curr_idx < curr_comps.size() || next_time_slot() == true)
+    {
+      p_comp = curr_comps[curr_idx];
+      timed_queue_order.dispatch++;
+      timed_queue_order.push = 0;
+      if (partitions.empty() == false)
+      {
+        dispatch_log.push_back(GeqDispatch(curr_time, p_comp, timed_queue_order.dispatch));
+      }
+
+      switch (p_comp->type)
       {
         case ct_core:
         case ct_o3core:
         case ct_o3core_t1:
         case ct_o3core_t2:
-          p_comp = *comp_iter;
-
-          event_queue_iter->second.erase(comp_iter);
-          if (event_queue_iter->second.empty() == true)
-          {
-            event_queue.erase(event_queue_iter);
-          }
+          curr_idx++;
+          if (p_comp->geq_time == curr_time) p_comp->geq_time = ~(uint64_t)0;
 
           ret_val = p_comp->process_event(curr_time);
           if (ret_val < num_hthreads)
@@ -246,18 +470,15 @@ uint32_t GlobalEventQueue::process_event()
         case ct_tlbl1i:
         case ct_mesh:
         case ct_ring:
-          p_comp = *comp_iter;
-
+          // events added to p_comp at curr_time during its processing are dropped
+          curr_idx++;
+          curr_comp = p_comp;
           p_comp->process_event(curr_time);
-
-          event_queue.begin()->second.erase(comp_iter);
-          if (event_queue_iter->second.empty() == true)
-          {
-            event_queue.erase(event_queue_iter);
-          }
+          curr_comp = NULL;
+          if (p_comp->geq_time == curr_time) p_comp->geq_time = ~(uint64_t)0;
           break;
         default:
-          cout << "  -- unsupported component type " << (*comp_iter)->type << endl;
+          cout << "  -- unsupported component type " << p_comp->type << endl;
           exit(1);
           break;
       }
@@ -307,9 +528,382 @@ uint32_t GlobalEventQueue::process_event()
 
 
 
+void GlobalEventQueue::start_pdes(
+    const std::vector<Component *> & mcs,
+    uint64_t lookahead_,
+    uint32_t num_threads)
+{
+  ASSERTX((partitions.empty() == true && lookahead_ > 0));
+  lqe_locked = true;
+  lookahead  = lookahead_;
+
+  for (uint32_t i = 0; i < mcs.size(); i++)
+  {
+    ASSERTX((mcs[i]->num == i));
+    partitions.push_back(new GeqPartition(mcs[i]));
+  }
+
+  // events already scheduled (at construction) are redistributed to the partitions
+  std::vector<geq_event_t> events(far_events);
+  for (uint32_t i = curr_idx; i < curr_comps.size(); i++)
+  {
+    events.push_back(geq_event_t(curr_time, curr_comps[i]));
+  }
+  for (uint64_t idx = 0; idx < wheel.size(); idx++)
+  {
+    for (uint32_t i = 0; i < wheel[idx].size(); i++)
+    {
+      events.push_back(geq_event_t(wheel_time + ((idx - wheel_time) & wheel_mask), wheel[idx][i]));
+    }
+    wheel[idx].clear();
+  }
+  std::fill(wheel_bitmap.begin(), wheel_bitmap.end(), 0);
+  num_wheel_events = 0;
+  far_events.clear();
+  curr_comps.clear();
+  curr_idx = 0;
+  for (uint32_t i = 0; i < events.size(); i++)
+  {
+    events[i].second->geq_time = ~(uint64_t)0;
+  }
+  for (uint32_t i = 0; i < events.size(); i++)
+  {
+    add_event(events[i].first, events[i].second);
+  }
+
+  num_workers = (num_threads == 0) ? 1 : ((num_threads < mcs.size()) ? num_threads : mcs.size());
+  for (uint32_t i = 0; i < num_workers; i++)
+  {
+    workers.push_back(std::thread(&GlobalEventQueue::run_worker, this, i));
+  }
+  cout << "  -- pts.geq.pdes : " << mcs.size() << " memory controllers on " << num_workers
+    << " threads, window = " << lookahead << endl;
+}
+
+
+
+void GlobalEventQueue::sync_pdes()
+{
+  if (partitions.empty() == true) return;
+
+  wait_window();
+  deliver();
+
+  // at curr_time, the memory controllers before the latest processed component
+  // were already processed in serial simulation
+  Component * last_comp = (curr_idx > 0) ? curr_comps[curr_idx - 1] : NULL;
+  for (uint32_t i = 0; i < partitions.size(); i++)
+  {
+    GeqPartition * part = partitions[i];
+    run_partition(part, (last_comp != NULL && part->mc < last_comp) ? curr_time + 1 : curr_time);
+  }
+  if (window_open == true && mc_end < curr_time)
+  {
+    mc_end = curr_time;
+  }
+  deliver();
+}
+
+
+
+void GlobalEventQueue::stop_pdes()
+{
+  if (partitions.empty() == true) return;
+
+  sync_pdes();
+  {
+    std::lock_guard<std::mutex> lock(pdes_mutex);
+    pdes_quit = true;
+  }
+  pdes_start_cv.notify_all();
+  for (uint32_t i = 0; i < workers.size(); i++)
+  {
+    workers[i].join();
+  }
+  workers.clear();
+
+  // the memory controllers go back to the main queue
+  std::vector<geq_event_t> events;
+  for (uint32_t i = 0; i < partitions.size(); i++)
+  {
+    GeqPartition * part = partitions[i];
+    for (uint32_t j = 0; j < part->times.size(); j++)
+    {
+      events.push_back(geq_event_t(part->times[j], part->mc));
+    }
+    part->mc->geq_time = ~(uint64_t)0;
+    delete part;
+  }
+  partitions.clear();
+  dispatch_log.clear();
+  lqe_locked = false;
+  for (uint32_t i = 0; i < events.size(); i++)
+  {
+    add_event(events[i].first, events[i].second);
+  }
+}
+
+
+
+bool GlobalEventQueue::defer_req_event(
+    uint64_t event_time,
+    LocalQueueElement * local_event,
+    Component * from,
+    Component * to)
+{
+  if (partitions.empty() == true || delivering == true) return false;
+
+  if (window_open == false || event_time < mc_end)
+  {
+    cout << "  -- pts.geq.pdes : a request to MC [" << to->num << "] at cycle " << event_time
+      << " is behind its simulation (cycle " << mc_end << "); set pts.geq.pdes = false" << endl;
+    exit(1);
+  }
+  partitions[to->num]->inbox.push_back(GeqMessage(event_time, curr_time, local_event, from, to));
+  return true;
+}
+
+
+
+void GlobalEventQueue::post_rep_event(
+    uint64_t event_time,
+    LocalQueueElement * local_event,
+    Component * from,
+    Component * to)
+{
+  if (partitions.empty() == true)
+  {
+    to->add_rep_event(event_time, local_event);
+  }
+  else
+  {
+    GeqPartition * part = partitions[from->num];
+    part->outbox.push_back(GeqMessage(event_time, part->curr_time, local_event, from, to));
+  }
+}
+
+
+
+bool GlobalEventQueue::next_window()
+{
+  wait_window();
+  deliver();
+
+  uint64_t main_time;
+  bool     has_main = peek_time(main_time);
+  uint64_t mc_time  = ~(uint64_t)0;
+  for (uint32_t i = 0; i < partitions.size(); i++)
+  {
+    if (partitions[i]->times.empty() == false && partitions[i]->times.front() < mc_time)
+    {
+      mc_time = partitions[i]->times.front();
+    }
+  }
+
+  if (has_main == false && mc_time == ~(uint64_t)0)
+  {
+    // as in serial simulation, curr_time is that of the latest event
+    window_open = false;
+    for (uint32_t i = 0; i < partitions.size(); i++)
+    {
+      curr_time = (partitions[i]->curr_time > curr_time) ? partitions[i]->curr_time : curr_time;
+    }
+    dispatch_log.clear();
+    return false;
+  }
+
+  // skip the cycles where neither side has anything to do
+  uint64_t start = (has_main == true) ? main_time : ~(uint64_t)0;
+  if (mc_time != ~(uint64_t)0 && mc_time + lookahead < start)
+  {
+    start = mc_time + lookahead;
+  }
+  if (window_open == true && start < main_end)
+  {
+    start = main_end;
+  }
+
+  // replies generated from now on are not older than log_start
+  uint64_t log_start = (mc_time < start) ? mc_time : start;
+  uint32_t num_old   = 0;
+  while (num_old < dispatch_log.size() && dispatch_log[num_old].time < log_start)
+  {
+    num_old++;
+  }
+  dispatch_log.erase(dispatch_log.begin(), dispatch_log.begin() + num_old);
+
+  window_open = true;
+  mc_end      = start;
+  main_end    = start + lookahead;
+  {
+    std::lock_guard<std::mutex> lock(pdes_mutex);
+    pdes_num_busy = num_workers;
+    pdes_window++;
+  }
+  pdes_start_cv.notify_all();
+  return true;
+}
+
+
+
+void GlobalEventQueue::wait_window()
+{
+  std::unique_lock<std::mutex> lock(pdes_mutex);
+  while (pdes_num_busy > 0)
+  {
+    pdes_done_cv.wait(lock);
+  }
+}
+
+
+
+static bool reply_before(const GeqMessage & lhs, const GeqMessage & rhs)
+{
+  return lhs.order.dispatch < rhs.order.dispatch ||
+    (lhs.order.dispatch == rhs.order.dispatch && (lhs.gen_time < rhs.gen_time ||
+    (lhs.gen_time == rhs.gen_time && lhs.from < rhs.from)));
+}
+
+
+
+void GlobalEventQueue::deliver()
+{
+  delivering = true;
+
+  // a reply is pushed as if it was made between the main-thread dispatches
+  // around the processing of its memory controller in serial simulation
+  std::vector<GeqMessage> replies;
+  for (uint32_t i = 0; i < partitions.size(); i++)
+  {
+    replies.insert(replies.end(), partitions[i]->outbox.begin(), partitions[i]->outbox.end());
+    partitions[i]->outbox.clear();
+  }
+  for (uint32_t i = 0; i < replies.size(); i++)
+  {
+    GeqMessage & reply = replies[i];
+    reply.order.dispatch = timed_queue_order.dispatch;
+    for (uint32_t j = 0; j < dispatch_log.size(); j++)
+    {
+      if (dispatch_log[j].time > reply.gen_time ||
+          (dispatch_log[j].time == reply.gen_time && dispatch_log[j].comp > reply.from))
+      {
+        reply.order.dispatch = dispatch_log[j].dispatch - 1;
+        break;
+      }
+    }
+  }
+  std::stable_sort(replies.begin(), replies.end(), reply_before);
+
+  PushOrder order = timed_queue_order;
+  for (uint32_t i = 0; i < replies.size(); i++)
+  {
+    ASSERTX((window_open == false || replies[i].event_time >= main_end));
+    // above any push made during the dispatch itself
+    timed_queue_order.dispatch = replies[i].order.dispatch;
+    timed_queue_order.push     = ((uint64_t)1 << 63) + num_replies++;
+    replies[i].to->add_rep_event(replies[i].event_time, replies[i].lqe);
+  }
+  timed_queue_order = order;
+
+  for (uint32_t i = 0; i < partitions.size(); i++)
+  {
+    std::vector<GeqMessage> & inbox = partitions[i]->inbox;
+    for (uint32_t j = 0; j < inbox.size(); j++)
+    {
+      inbox[j].to->add_req_event(inbox[j].event_time, inbox[j].lqe, inbox[j].from);
+    }
+    inbox.clear();
+  }
+
+  delivering = false;
+}
+
+
+
+void GlobalEventQueue::run_partition(GeqPartition * part, uint64_t end_time)
+{
+  Component * mc = part->mc;
+
+  while (part->times.empty() == false && part->times.front() < end_time)
+  {
+    uint64_t event_time = part->times.front();
+    while (part->times.empty() == false && part->times.front() == event_time)
+    {
+      std::pop_heap(part->times.begin(), part->times.end(), std::greater<uint64_t>());
+      part->times.pop_back();
+    }
+
+    // as for the main queue, events added at event_time during its processing are dropped
+    part->curr_time  = event_time;
+    part->in_process = true;
+    mc->process_event(event_time);
+    part->in_process = false;
+    if (mc->geq_time == event_time) mc->geq_time = ~(uint64_t)0;
+  }
+}
+
+
+
+void GlobalEventQueue::run_worker(uint32_t id)
+{
+  uint64_t window = 0;
+
+  while (true)
+  {
+    {
+      std::unique_lock<std::mutex> lock(pdes_mutex);
+      while (pdes_quit == false && pdes_window == window)
+      {
+        pdes_start_cv.wait(lock);
+      }
+      if (pdes_quit == true) return;
+      window = pdes_window;
+    }
+
+    for (uint32_t i = id; i < partitions.size(); i += num_workers)
+    {
+      run_partition(partitions[i], mc_end);
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(pdes_mutex);
+      pdes_num_busy--;
+      if (pdes_num_busy == 0) pdes_done_cv.notify_one();
+    }
+  }
+}
+
+
+
 void GlobalEventQueue::display()
 {
-  event_queue_t::iterator event_queue_iter = event_queue.begin();
+  std::map<uint64_t, std::set<Component *> > event_queue;  // pending events in time order
+
+  for (uint32_t i = curr_idx; i < curr_comps.size(); i++)
+  {
+    event_queue[curr_time].insert(curr_comps[i]);
+  }
+  for (uint64_t idx = 0; idx < wheel.size(); idx++)
+  {
+    for (uint32_t i = 0; i < wheel[idx].size(); i++)
+    {
+      event_queue[wheel_time + ((idx - wheel_time) & wheel_mask)].insert(wheel[idx][i]);
+    }
+  }
+  for (uint32_t i = 0; i < far_events.size(); i++)
+  {
+    event_queue[far_events[i].first].insert(far_events[i].second);
+  }
+  wait_window();
+  for (uint32_t i = 0; i < partitions.size(); i++)
+  {
+    for (uint32_t j = 0; j < partitions[i]->times.size(); j++)
+    {
+      event_queue[partitions[i]->times[j]].insert(partitions[i]->mc);
+    }
+  }
+
+  std::map<uint64_t, std::set<Component *> >::iterator event_queue_iter = event_queue.begin();
 
   cout << "  -- global event queue : at cycle = " << curr_time << endl;
 
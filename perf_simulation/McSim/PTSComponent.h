@@ -33,7 +33,11 @@
 
 #include "PTS.h"
 #include <set>
+#include <algorithm>
 #include <iostream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 using namespace std;
 
@@ -109,9 +113,35 @@ namespace PinPthread
     et_nop,
   };
 
+  // return path of a LocalQueueElement : the std::stack<Component *> interface
+  // on an inline array, as the hierarchy (core, L1, L2, NoC, directory, MC) is shallow
+  class ReturnPath
+  {
+    public:
+      static const uint32_t max_depth = 16;
+
+      ReturnPath() : num(0) { }
+      ReturnPath(const ReturnPath & rhs) : num(rhs.num) { copy(rhs); }
+      ReturnPath & operator=(const ReturnPath & rhs) { num = rhs.num; copy(rhs); return *this; }
+
+      bool        empty() const { return num == 0; }
+      uint32_t    size() const  { return num; }
+      Component * top() const   { return comps[num - 1]; }
+      void        push(Component * comp) { ASSERTX((num < max_depth)); comps[num++] = comp; }
+      void        pop()         { num--; }
+
+    private:
+      uint32_t    num;
+      Component * comps[max_depth];
+
+      void copy(const ReturnPath & rhs) { for (uint32_t i = 0; i < num; i++) comps[i] = rhs.comps[i]; }
+  };
+
+  // LocalQueueElements are recycled through a free list instead of going back
+  // to the heap, so new/delete on them stays allocation-free in steady state
   struct LocalQueueElement
   {
-    std::stack<Component *> from;  // where it is from
+    ReturnPath from;  // where it is from
     event_type type;
     uint64_t   address;
     uint32_t   th_id;
@@ -124,6 +154,67 @@ namespace PinPthread
       : from(), type(type_), address(address_), th_id(0), dummy(false), prefetch(0), rob_entry(-1) { from.push(comp); }
 
     void display();
+
+    static void * operator new(size_t size);
+    static void   operator delete(void * lqe);
+  };
+
+
+
+  // arrival order of the events in all TimedQueues : the number of
+  // components the global event queue has dispatched, then the pushes since.
+  // only the main simulation thread pushes to TimedQueues.
+  struct PushOrder
+  {
+    uint64_t dispatch;
+    uint64_t push;
+  };
+  extern PushOrder timed_queue_order;
+
+  // timed events on a binary min-heap in contiguous storage; events of
+  // the same time leave in arrival order, as from a std::multimap
+  template <class T>
+  class TimedQueue
+  {
+    public:
+      TimedQueue() : events() { }
+
+      bool      empty() const    { return events.empty(); }
+      size_t    size() const     { return events.size(); }
+      uint64_t  top_time() const { return events.front().time; }
+      const T & top() const      { return events.front().item; }
+      // is the earliest event at curr_time?
+      bool      ready(uint64_t curr_time) const { return events.empty() == false && events.front().time == curr_time; }
+
+      void push(uint64_t time, const T & item)
+      {
+        events.push_back(Event(time, timed_queue_order, item));
+        timed_queue_order.push++;
+        std::push_heap(events.begin(), events.end());
+      }
+      void pop()
+      {
+        std::pop_heap(events.begin(), events.end());
+        events.pop_back();
+      }
+
+    private:
+      struct Event
+      {
+        uint64_t  time;
+        PushOrder order;  // ties on time are broken by arrival
+        T         item;
+
+        Event(uint64_t time_, const PushOrder & order_, const T & item_) : time(time_), order(order_), item(item_) { }
+        // reversed, as std::push_heap builds a max-heap
+        bool operator<(const Event & rhs) const
+        {
+          return time > rhs.time || (time == rhs.time && (order.dispatch > rhs.order.dispatch ||
+                (order.dispatch == rhs.order.dispatch && order.push > rhs.order.push)));
+        }
+      };
+
+      std::vector<Event> events;
   };
 
 
@@ -139,6 +230,7 @@ namespace PinPthread
       uint32_t                 num;
       McSim                  * mcsim;
       GlobalEventQueue       * geq;  // global event queue
+      uint64_t                 geq_time;  // time of its latest add_event to geq
 
       virtual void add_req_event(uint64_t, LocalQueueElement *, Component * from) { ASSERTX(0); }
       virtual void add_rep_event(uint64_t, LocalQueueElement *, Component * from) { ASSERTX(0); }
@@ -148,8 +240,8 @@ namespace PinPthread
       virtual void show_state(uint64_t address) { }
       virtual void display();
 
-      std::multimap<uint64_t, LocalQueueElement *> req_event;
-      std::multimap<uint64_t, LocalQueueElement *> rep_event;
+      TimedQueue<LocalQueueElement *> req_event;
+      TimedQueue<LocalQueueElement *> rep_event;
       std::queue<LocalQueueElement *> req_q;
       std::queue<LocalQueueElement *> rep_q;
 
@@ -163,13 +255,65 @@ namespace PinPthread
 
 
 
-  typedef std::map<uint64_t, std::set<Component *> > event_queue_t;
+  // conservative parallel simulation (pts.geq.pdes = true) : each memory
+  // controller is a partition with its own event times, simulated by worker
+  // threads.  while the main thread processes [mc_end, main_end), the workers
+  // bring the memory controllers up to mc_end.  main_end - mc_end is half of
+  // the shortest mc_to_dir_t, so requests from the directories and replies to
+  // them are exchanged at the window boundaries before they are due.
+  struct GeqMessage  // a request to or a reply from a partition
+  {
+    uint64_t            event_time;
+    uint64_t            gen_time;
+    LocalQueueElement * lqe;
+    Component         * from;
+    Component         * to;
+    PushOrder           order;  // where a reply falls in the serial order
+
+    GeqMessage(uint64_t event_time_, uint64_t gen_time_, LocalQueueElement * lqe_, Component * from_, Component * to_)
+      : event_time(event_time_), gen_time(gen_time_), lqe(lqe_), from(from_), to(to_), order() { }
+  };
+
+  struct GeqPartition
+  {
+    Component * mc;
+    std::vector<uint64_t>   times;   // min-heap, may repeat
+    uint64_t                curr_time;
+    bool                    in_process;
+    std::vector<GeqMessage> inbox;   // requests, in arrival order
+    std::vector<GeqMessage> outbox;  // replies, in generation order
+
+    GeqPartition(Component * mc_) : mc(mc_), times(), curr_time(0), in_process(false), inbox(), outbox() { }
+  };
+
+  struct GeqDispatch  // a component processed by the main thread
+  {
+    uint64_t    time;
+    Component * comp;
+    uint64_t    dispatch;  // timed_queue_order.dispatch during its processing
+
+    GeqDispatch(uint64_t time_, Component * comp_, uint64_t dispatch_) : time(time_), comp(comp_), dispatch(dispatch_) { }
+  };
+
+  // global event queue : a timing wheel of one-cycle buckets covering the
+  // next (1 << pts.geq.wheel_bits) cycles, and a min-heap for the events beyond
+  // (or before) the wheel.  at each cycle the components are processed once,
+  // in ascending address order, as with std::map<uint64_t, std::set<Component *> >.
+  typedef std::pair<uint64_t, Component *> geq_event_t;  // <time, target>
 
   class GlobalEventQueue
   {
     public:
     //private:
-      event_queue_t event_queue;
+      std::vector<std::vector<Component *> > wheel;  // unsorted, may repeat
+      std::vector<uint64_t> wheel_bitmap;  // which buckets are not empty
+      uint64_t wheel_time;  // the wheel holds [wheel_time, wheel_time + wheel.size())
+      uint64_t wheel_mask;
+      uint64_t num_wheel_events;
+      std::vector<geq_event_t> far_events;  // min-heap
+      std::vector<Component *> curr_comps;  // targets at curr_time, sorted
+      uint32_t curr_idx;  // curr_comps[curr_idx..] are not processed yet
+      Component * curr_comp;  // non-core component being processed
       uint64_t curr_time;
       McSim * mcsim;
 
@@ -178,9 +322,47 @@ namespace PinPthread
       ~GlobalEventQueue();
       void add_event(uint64_t event_time, Component *);
       uint32_t process_event();
+      bool empty();
       void display();
 
+      // parallel simulation of the memory controllers; mcs[i]->num must be i
+      void start_pdes(const std::vector<Component *> & mcs, uint64_t lookahead, uint32_t num_threads);
+      void sync_pdes();  // bring the memory controllers up to curr_time
+      void stop_pdes();
+      // true if a request to a partition is held until the window ends
+      bool defer_req_event(uint64_t event_time, LocalQueueElement *, Component * from, Component * to);
+      // a reply from from (a memory controller) to to
+      void post_rep_event(uint64_t event_time, LocalQueueElement *, Component * from, Component * to);
 
+    private:
+      bool next_time_slot();  // move the earliest targets to curr_comps
+      bool first_wheel_time(uint64_t & event_time) const;
+      bool peek_time(uint64_t & event_time) const;
+
+      bool next_window();  // false if no event is left anywhere
+      void wait_window();
+      void deliver();
+      void run_partition(GeqPartition * part, uint64_t end_time);
+      void run_worker(uint32_t id);
+
+      std::vector<GeqPartition *> partitions;  // indexed by MemoryController::num
+      std::vector<GeqDispatch>    dispatch_log;
+      std::vector<std::thread>    workers;
+      uint32_t                    num_workers;
+      std::mutex                  pdes_mutex;
+      std::condition_variable     pdes_start_cv;
+      std::condition_variable     pdes_done_cv;
+      uint64_t pdes_window;    // id of the latest window
+      uint32_t pdes_num_busy;  // workers not done with it
+      bool     pdes_quit;
+      bool     window_open;
+      uint64_t mc_end;
+      uint64_t main_end;
+      uint64_t lookahead;
+      bool     delivering;
+      uint64_t num_replies;
+
+    public:
       uint32_t num_hthreads;
       uint32_t num_mcs;
       uint32_t interleave_base_bit;
@@ -142,7 +142,7 @@ void Directory::add_req_event(
     event_time = event_time + process_interval - event_time%process_interval;
   }
   geq->add_event(event_time, this);
-  req_event.insert(pair<uint64_t, LocalQueueElement *>(event_time, local_event));
+  req_event.push(event_time, local_event);
 }
 
 
@@ -159,19 +159,17 @@ void Directory::add_rep_event(
 
   if (local_event->type == et_rd_dir_info_req)
   {
-    req_event.insert(pair<uint64_t, LocalQueueElement *>(event_time, local_event));
+    req_event.push(event_time, local_event);
   }
   else
   {
-    rep_event.insert(pair<uint64_t, LocalQueueElement *>(event_time, local_event));
+    rep_event.push(event_time, local_event);
   }
 }
 
 
 uint32_t Directory::process_event(uint64_t curr_time)
 {
-  multimap<uint64_t, LocalQueueElement *>::iterator req_event_iter = req_event.begin();
-  multimap<uint64_t, LocalQueueElement *>::iterator rep_event_iter = rep_event.begin();
 
   LocalQueueElement * rep_lqe = NULL;
   LocalQueueElement * req_lqe = NULL;
@@ -182,18 +180,17 @@ uint32_t Directory::process_event(uint64_t curr_time)
     rep_lqe = rep_q.front();
     rep_q.pop();
   }
-  else if (rep_event_iter != rep_event.end() && rep_event_iter->first == curr_time)
+  else if (rep_event.ready(curr_time) == true)
   {
-    rep_lqe = rep_event_iter->second;
-    ++rep_event_iter;
+    rep_lqe = rep_event.top();
+    rep_event.pop();
   }
 
-  while (rep_event_iter != rep_event.end() && rep_event_iter->first == curr_time)
+  while (rep_event.ready(curr_time) == true)
   {
-    rep_q.push(rep_event_iter->second);
-    ++rep_event_iter;
+    rep_q.push(rep_event.top());
+    rep_event.pop();
   }
-  rep_event.erase(curr_time);
 
 
   if (rep_lqe != NULL)
@@ -205,22 +202,21 @@ uint32_t Directory::process_event(uint64_t curr_time)
     req_lqe = req_q.front();
     req_q.pop();
   }
-  else if (req_event_iter != req_event.end() && req_event_iter->first == curr_time)
+  else if (req_event.ready(curr_time) == true)
   {
-    req_lqe = req_event_iter->second;
-    ++req_event_iter;
+    req_lqe = req_event.top();
+    req_event.pop();
   }
   else
   {
-    display();  req_event_iter->second->display();  geq->display();  ASSERTX(0);
+    display();  if (req_event.empty() == false) req_event.top()->display();  geq->display();  ASSERTX(0);
   }
 
-  while (req_event_iter != req_event.end() && req_event_iter->first == curr_time)
+  while (req_event.ready(curr_time) == true)
   {
-    req_q.push(req_event_iter->second);
-    ++req_event_iter;
+    req_q.push(req_event.top());
+    req_event.pop();
   }
-  req_event.erase(curr_time);
 
   if (rep_q.empty() == false || req_q.empty() == false)
   {
@@ -1010,8 +1006,8 @@ uint32_t Directory::process_event(uint64_t curr_time)
   else
   {
     geq->display(); 
-    if (req_event_iter != req_event.end()) cout << req_event_iter->first << endl;
-    if (rep_event_iter != rep_event.end()) cout << rep_event_iter->first << endl;
+    if (req_event.empty() == false) cout << req_event.top_time() << endl;
+    if (rep_event.empty() == false) cout << rep_event.top_time() << endl;
     ASSERTX(0);
   }
 
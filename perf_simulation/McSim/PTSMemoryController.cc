@@ -139,6 +139,9 @@ MemoryController::MemoryController(
   num_pred_miss(0), num_pred_hit(0), num_global_pred_miss(0), num_global_pred_hit(0),
   accu_num_activated_bank(0),
   last_call_process_event(0),
+  num_activated_bank(0),
+  polling(false),
+  bliss_event_time(0),
   num_l_pred_miss(0), num_l_pred_hit(0), num_l_pred_miss_curr(0), num_l_pred_hit_curr(0),
   num_g_pred_miss(0), num_g_pred_hit(0), num_g_pred_miss_curr(0), num_g_pred_hit_curr(0),
   num_o_pred_miss(0), num_o_pred_hit(0), num_o_pred_miss_curr(0), num_o_pred_hit_curr(0),
@@ -434,7 +437,8 @@ MemoryController::MemoryController(
   my_bh->mc = this;
   if (bliss) {
     my_bliss = new Bliss(4, 10000 * process_interval);  // threshold and clearing interval
-    geq->add_event(my_bliss->clearing_interval, this);
+    bliss_event_time = my_bliss->clearing_interval;
+    geq->add_event(bliss_event_time, this);
   }
   
   /* RowHammer attackers (Denial-of-Service) */
@@ -555,18 +559,6 @@ MemoryController::~MemoryController()
 {
   if (num_read > 0)
   {
-    uint64_t num_activated_bank = 0;
-    for (uint32_t i = 0; i < num_ranks_per_mc; i++)
-    {
-      for (uint32_t j = 0; j < num_banks_per_rank + num_banks_per_rank_ab; j++)
-      {
-        if (bank_status[i][j].action_type == mc_bank_activate
-           || bank_status[i][j].action_type == mc_bank_read || bank_status[i][j].action_type == mc_bank_write)
-        {
-          num_activated_bank++;
-        }
-      }
-    }
     accu_num_activated_bank += (mcsim->get_curr_time() - last_call_process_event) / process_interval * num_activated_bank;
     cout << "  -- MC  [" << setw(3) << num << "] : (rd, wr, act, res, pre) = ("
          << setw(9) << num_read << ", " << setw(9) << num_write << ", "
@@ -687,6 +679,11 @@ void MemoryController::add_req_event(
     LocalQueueElement * local_event,
     Component * from)
 {
+  if (geq->defer_req_event(event_time, local_event, from, this) == true)
+  {
+    return;  // delivered at the end of the current window (pts.geq.pdes)
+  }
+
   if (event_time % process_interval != 0)
   {
     event_time += process_interval - event_time%process_interval;
@@ -746,7 +743,7 @@ void MemoryController::add_req_event(
   else
   {
     geq->add_event(event_time, this);
-    req_event.insert(pair<uint64_t, LocalQueueElement *>(event_time, local_event));
+    req_event.push(event_time, local_event);
     event_n_time.insert(pair<LocalQueueElement *, uint64_t>(local_event, event_time));
   }
 
@@ -765,6 +762,18 @@ void MemoryController::add_req_event(
 //  }
 }
 
+bool MemoryController::pdes_capable() const
+{
+  // it must talk only to its own directory, through add_req_event and
+  // post_rep_event, and not draw from the process-wide rand() (PARA)
+  return is_shared_llc == false && is_fixed_latency == false && is_fixed_bw_n_latency == false &&
+    rh_mode != rh_para && display_page_acc_pattern == false &&
+    directory != NULL && directory->type == ct_directory &&
+    static_cast<Directory *>(directory)->memorycontroller == this &&
+    static_cast<Directory *>(directory)->dir_to_mc_t > 0;
+}
+
+
 void MemoryController::add_rep_event(
     uint64_t event_time,
     LocalQueueElement * local_event,
@@ -872,19 +881,21 @@ void MemoryController::show_state(uint64_t curr_time)
 
 uint32_t MemoryController::process_event(uint64_t curr_time)
 {
-  // for the standby current calculation considering IDD2N instead of IDD3N 
-  uint64_t num_activated_bank = 0;
-  for (uint32_t i = 0; i < num_ranks_per_mc; i++)
+  // an event of next_idle_event_time() stands for the per-cycle polling it
+  // skips. when a later call stopped polling (its last request was served),
+  // the event no longer has a source, and the call is dropped.
+  if (polling == false && req_event.ready(curr_time) == false &&
+      (refresh_interval == 0 || curr_time % (refresh_interval / num_ranks_per_mc) != 0) &&
+      (bliss == false || curr_time != bliss_event_time))
   {
-    for (uint32_t j = 0; j < num_banks_per_rank + num_banks_per_rank_ab; j++)
-    {
-      if (bank_status[i][j].action_type == mc_bank_activate
-      || bank_status[i][j].action_type == mc_bank_read || bank_status[i][j].action_type == mc_bank_write)
-      {
-        num_activated_bank++;
-      }
-    }
+    return 0;
   }
+  if (curr_time != last_call_process_event)
+  {
+    polling = false;
+  }
+
+  // for the standby current calculation considering IDD2N instead of IDD3N 
   accu_num_activated_bank += (curr_time - last_call_process_event) / process_interval * num_activated_bank;
   last_call_process_event = curr_time;
 
@@ -896,7 +907,8 @@ uint32_t MemoryController::process_event(uint64_t curr_time)
 
   if (bliss && curr_time % (my_bliss->clearing_interval) == 0 && req_l.size() != 0) {
     my_bliss->clear_blacklist();
-    geq->add_event(curr_time + my_bliss->clearing_interval, this);
+    bliss_event_time = curr_time + my_bliss->clearing_interval;
+    geq->add_event(bliss_event_time, this);
   }
 
   pre_processing(curr_time);
@@ -929,7 +941,7 @@ uint32_t MemoryController::process_event(uint64_t curr_time)
       // trigger swap for all ranks, banks in MC
       for (uint32_t j = 0; j < num_banks_per_rank; ++j) {
         BankStatus &curr_bank = bank_status[rn][j];
-        curr_bank.action_type = mc_bank_precharge;
+        set_bank_action(curr_bank, mc_bank_precharge);
         curr_bank.action_type_prev = mc_bank_refresh;
         // PRE the current row and two row swaps
         curr_bank.action_time = curr_time + ((tRAS + tRP + rrs_delay_row_swap * 2) * process_interval);
@@ -966,7 +978,7 @@ uint32_t MemoryController::process_event(uint64_t curr_time)
       abacus[target_rankn]->refresh_cycle();
       for (uint32_t j = 0; j < num_banks_per_rank; ++j) {
         BankStatus &curr_bank = bank_status[target_rankn][j];
-        curr_bank.action_type = mc_bank_precharge;
+        set_bank_action(curr_bank, mc_bank_precharge);
         curr_bank.action_type_prev = mc_bank_refresh;
         curr_bank.action_time = curr_time + (tRAS + tRP) * process_interval + tRFC_t * 8192; // ???
       }
@@ -1001,7 +1013,7 @@ uint32_t MemoryController::process_event(uint64_t curr_time)
       abacus[rankn]->preventive_refresh();
       for (uint32_t j = 0; j < num_banks_per_rank; ++j) {
         BankStatus &curr_bank = bank_status[rankn][j];
-        curr_bank.action_type = mc_bank_precharge;
+        set_bank_action(curr_bank, mc_bank_precharge);
         curr_bank.action_type_prev = mc_bank_refresh;
         curr_bank.action_time = curr_time +  2 * (tRAS + tRP) * process_interval * blast_radius;
       }
@@ -1012,7 +1024,7 @@ uint32_t MemoryController::process_event(uint64_t curr_time)
   if (refresh_interval != 0 && curr_time % (refresh_interval / num_ranks_per_mc) == 0)
   {
     geq->add_event(curr_time + refresh_interval/num_ranks_per_mc, this);  // add next event
-    geq->add_event(curr_time + process_interval, this);
+    add_poll_event(curr_time + process_interval);
     num_refresh++;
     curr_refresh_rank = (curr_refresh_rank + 1) % num_ranks_per_mc;
     curr_refresh_page = (curr_refresh_page + ((curr_refresh_rank == 0) ? (num_pages_per_bank / 8192) : 0)) % num_pages_per_bank;
@@ -1025,7 +1037,7 @@ uint32_t MemoryController::process_event(uint64_t curr_time)
       { //print cmd when bank is precharged in closed policy 
         show_page_acc_pattern(curr_bank.th_id, curr_refresh_rank, j, curr_bank.page_num, mc_bank_precharge, curr_bank.action_time);
       }
-      curr_bank.action_type       = mc_bank_precharge;
+      set_bank_action(curr_bank, mc_bank_precharge);
       curr_bank.action_type_prev  = mc_bank_refresh;
       curr_bank.action_time  = curr_time + tRFC_t - tRP*process_interval;
       curr_bank.page_num     = curr_refresh_page;
@@ -1119,7 +1131,7 @@ uint32_t MemoryController::process_event(uint64_t curr_time)
           if (todo_RFM_flag[i][j]) {
             todo_RFM_flag[i][j] = false;
             BankStatus &curr_bank = bank_status[i][j];
-            curr_bank.action_type = mc_bank_precharge;
+            set_bank_action(curr_bank, mc_bank_precharge);
             curr_bank.action_time = curr_time + tRFM_t; // per-bank RFM
             RAA_counter[i][j] -= RAAIMT;
             num_RFM[i][j]++;
@@ -1135,7 +1147,7 @@ uint32_t MemoryController::process_event(uint64_t curr_time)
           if (todo_RFM_flag[i][j]) {
             todo_RFM_flag[i][j] = false;
             BankStatus &curr_bank = bank_status[i][j];
-            curr_bank.action_type = mc_bank_precharge;
+            set_bank_action(curr_bank, mc_bank_precharge);
             curr_bank.action_time = curr_time + tRFM_t; // per-bank RFM
             num_RFM[i][j]++;
           }
@@ -1145,16 +1157,11 @@ uint32_t MemoryController::process_event(uint64_t curr_time)
   }
 
   if ((policy == mc_sched_m_open || policy == mc_sched_a_open) && req_l.empty() == true) {
-    // minimalist open need to check a bank unless it is already precharged
-    for (uint32_t i = 0; i < num_ranks_per_mc; i++) {
-      for(uint32_t k = 0; k < num_banks_per_rank + num_banks_per_rank_ab; k++) {
-        BankStatus & curr_bank = bank_status[i][k];
-        if (curr_bank.action_type != mc_bank_precharge && curr_bank.action_type != mc_bank_idle) {
-          i = num_ranks_per_mc;
-          geq->add_event(curr_time + process_interval, this);
-          break;
-        }
-      }
+    // minimalist open need to check a bank unless it is already precharged,
+    // but nothing changes before the earliest open bank times out
+    uint64_t next_time = next_idle_event_time(curr_time);
+    if (next_time != 0) {
+      add_poll_event(next_time);
     }
   }
 
@@ -1632,7 +1639,7 @@ uint32_t MemoryController::process_event(uint64_t curr_time)
         curr_bank.action_time = curr_time;
         curr_bank.page_num    = page_num;
         curr_bank.th_id       = th_id;
-        curr_bank.action_type = mc_bank_activate;
+        set_bank_action(curr_bank, mc_bank_activate);
         last_activate_time[rank_num] = curr_time;
         curr_bank.latest_activate_time = curr_time;
         num_activate++;
@@ -1777,7 +1784,7 @@ uint32_t MemoryController::process_event(uint64_t curr_time)
               my_bh->ACT(page_num, rank_num, bank_num, th_id, curr_time);
             }
 
-            curr_bank.action_type = mc_bank_activate;
+            set_bank_action(curr_bank, mc_bank_activate);
             curr_bank.page_num    = page_num;
             curr_bank.th_id       = th_id;
             last_activate_time[rank_num] = curr_time;
@@ -1838,7 +1845,7 @@ uint32_t MemoryController::process_event(uint64_t curr_time)
           else
           { // precharge
             num_precharge++;
-            curr_bank.action_type = mc_bank_precharge;
+            set_bank_action(curr_bank, mc_bank_precharge);
             if (policy == mc_sched_a_open && a_open_fixed_to == false)
             {
               a_open_opc++;
@@ -1960,7 +1967,7 @@ uint32_t MemoryController::process_event(uint64_t curr_time)
               else
               {
                 if (is_shared_llc) crossbar->add_mcrp_event(curr_time + mc_to_dir_t_curr, *iter, this);
-                else directory->add_rep_event(curr_time + mc_to_dir_t_curr, *iter);
+                else geq->post_rep_event(curr_time + mc_to_dir_t_curr, *iter, this, directory);
               }
               packet_time_in_mc_acc += (curr_time + mc_to_dir_t_curr - event_n_time[*iter]);
               event_n_time.erase(*iter);
@@ -1995,7 +2002,7 @@ uint32_t MemoryController::process_event(uint64_t curr_time)
                   ((policy == mc_sched_g_pred || (policy == mc_sched_tournament && curr_tournament_idx == mc_pred_global)) &&
                    global_bimodal_entry[th_id][pred_history[th_id]%num_history_patterns] < 2))
               {
-                curr_bank.action_type = mc_bank_read;
+                set_bank_action(curr_bank, mc_bank_read);
               }
               else
               {
@@ -2042,7 +2049,7 @@ uint32_t MemoryController::process_event(uint64_t curr_time)
                   }
                 }
                 curr_bank.action_type_prev = mc_bank_read;
-                curr_bank.action_type = mc_bank_precharge;
+                set_bank_action(curr_bank, mc_bank_precharge);
                 num_precharge++;
 
                 // When we have to refresh the current bank,
@@ -2224,7 +2231,7 @@ uint32_t MemoryController::process_event(uint64_t curr_time)
                 else
                 {
                   if (is_shared_llc) crossbar->add_mcrp_event(curr_time + mc_to_dir_t_curr, *iter, this);
-                  else directory->add_rep_event(curr_time + mc_to_dir_t_curr, *iter);
+                  else geq->post_rep_event(curr_time + mc_to_dir_t_curr, *iter, this, directory);
                 }
                 packet_time_in_mc_acc += (curr_time + mc_to_dir_t_curr - event_n_time[*iter]);
                 event_n_time.erase(*iter);
@@ -2265,7 +2272,7 @@ uint32_t MemoryController::process_event(uint64_t curr_time)
                   ((policy == mc_sched_g_pred || (policy == mc_sched_tournament && curr_tournament_idx == mc_pred_global)) &&
                    global_bimodal_entry[th_id][pred_history[th_id]%num_history_patterns] < 2))
               {
-                curr_bank.action_type = mc_bank_write;
+                set_bank_action(curr_bank, mc_bank_write);
               }
               else
               {
@@ -2290,7 +2297,7 @@ uint32_t MemoryController::process_event(uint64_t curr_time)
 
                 }
                 curr_bank.action_type_prev = mc_bank_write;
-                curr_bank.action_type = mc_bank_precharge;
+                set_bank_action(curr_bank, mc_bank_precharge);
                 num_precharge++;
                 
                 // When we have to refresh the current bank, 
@@ -2459,7 +2466,7 @@ uint32_t MemoryController::process_event(uint64_t curr_time)
             curr_bank.action_time = curr_time;
             curr_bank.action_type_prev = curr_bank.action_type;
             num_precharge++;
-            curr_bank.action_type = mc_bank_precharge;
+            set_bank_action(curr_bank, mc_bank_precharge);
 
             // When we have to refresh the current bank, 
             if (curr_bank.rh_ref) {
@@ -2488,7 +2495,7 @@ uint32_t MemoryController::process_event(uint64_t curr_time)
               curr_bank.rh_ref = false;
             }
 
-            geq->add_event(curr_time + process_interval, this);
+            add_poll_event(curr_time + process_interval);
             break;
           }
         }
@@ -2496,14 +2503,84 @@ uint32_t MemoryController::process_event(uint64_t curr_time)
     }
   }
 
+  // queued requests still poll every process_interval; the idle skip of
+  // next_idle_event_time() only covers an empty req_l.
   if (req_l.empty() == false)
   {
-    geq->add_event(curr_time + process_interval, this);
+    add_poll_event(curr_time + process_interval);
   }
 
   return 0;
 }
 
+void MemoryController::set_bank_action(BankStatus & bank, mc_bank_action type)
+{
+  num_activated_bank -= (bank.action_type == mc_bank_activate ||
+                         bank.action_type == mc_bank_read || bank.action_type == mc_bank_write) ? 1 : 0;
+  num_activated_bank += (type == mc_bank_activate ||
+                         type == mc_bank_read || type == mc_bank_write) ? 1 : 0;
+  bank.action_type = type;
+}
+
+
+void MemoryController::add_poll_event(uint64_t event_time)
+{
+  polling = true;
+  geq->add_event(event_time, this);
+}
+
+
+// when an open-page MC has no request, the next cycle at which the
+// precharge loop can close a bank (0 if every bank is closed already).
+// rowhammer and RFM work left for the next cycle keeps it ticking.
+uint64_t MemoryController::next_idle_event_time(uint64_t curr_time)
+{
+  bool     any_open   = false;
+  bool     next_cycle = false;
+  uint64_t ready_time = UINT64_MAX;
+
+  for (uint32_t i = 0; i < num_ranks_per_mc; i++) {
+    for (uint32_t k = 0; k < num_banks_per_rank + num_banks_per_rank_ab; k++) {
+      BankStatus & curr_bank = bank_status[i][k];
+      if ((rh_mode == rh_srs && curr_bank.rh_swap == true) ||
+          (rh_mode == rh_abacus && (curr_bank.rh_swap == true || curr_bank.rh_update == true)) ||
+          (RAAIMT != 0 && (rh_mode == rh_rampart || rh_mode == rh_prac) &&
+           k < num_banks_per_rank && todo_RFM_flag[i][k] == true)) {
+        next_cycle = true;
+      }
+      if (curr_bank.action_type == mc_bank_precharge || curr_bank.action_type == mc_bank_idle) {
+        continue;
+      }
+      any_open = true;
+      if (curr_bank.action_type != mc_bank_read && curr_bank.action_type != mc_bank_write) {
+        next_cycle = true;
+        continue;
+      }
+
+      // the conditions of the precharge loop in process_event
+      uint64_t t = curr_bank.action_time + (curr_bank.action_type == mc_bank_read ?
+                   max(tBBL, tRTP) : max(tBBLW, tWTP)) * process_interval;
+      t = max(t, curr_bank.latest_activate_time + (last_time_from_ab[i][k] ? tRAS_ab : tRAS) * process_interval);
+      if (policy == mc_sched_m_open) {
+        t = max(t, curr_bank.latest_activate_time + tM_OPEN_TO * process_interval);
+      }
+      else {
+        t = max(t, curr_bank.action_time + tA_OPEN_TO * process_interval);
+      }
+      ready_time = min(ready_time, t);
+    }
+  }
+
+  if (any_open == false) {
+    return 0;
+  }
+  if (next_cycle == true || ready_time <= curr_time + process_interval) {
+    return curr_time + process_interval;
+  }
+  return curr_time + (ready_time - curr_time + process_interval - 1) / process_interval * process_interval;
+}
+
+
 // [RFM]
 void MemoryController::update_RAA_counter(uint32_t rank_num, uint32_t bank_num) {
   RAA_counter[rank_num][bank_num]++;
@@ -2557,14 +2634,13 @@ bool MemoryController::pre_processing(uint64_t curr_time)
     num_c_pred_hit  += num_c_pred_hit_curr;   num_c_pred_hit_curr  = 0;
   }
 
-  multimap<uint64_t, LocalQueueElement *>::iterator req_event_iter = req_event.begin();
 
-  while (req_event_iter != req_event.end() && req_event_iter->first == curr_time)
+  while (req_event.ready(curr_time) == true)
   {
     // BlockHammer
     if (rh_mode == rh_blockhammer && my_bh->attackthrottler == true) {
-      uint64_t th_id = req_event_iter->second->th_id;
-      uint64_t addr = req_event_iter->second->address;
+      uint64_t th_id = req_event.top()->th_id;
+      uint64_t addr = req_event.top()->address;
       uint32_t rank_num = get_rank_num(addr);
       uint32_t bank_num = get_bank_num(addr, th_id);
       auto cur = my_bh->attackthrottlers[rank_num][bank_num];
@@ -2591,11 +2667,11 @@ bool MemoryController::pre_processing(uint64_t curr_time)
     }
     // PAR-BS, BLISS
     if (par_bs == true) {
-      num_req_from_a_th[req_event_iter->second->th_id]++;
+      num_req_from_a_th[req_event.top()->th_id]++;
     }
-    req_l.push_back(req_event_iter->second);
-    acc_from_a_th[req_event_iter->second->th_id]++;
-    ++req_event_iter;
+    req_l.push_back(req_event.top());
+    acc_from_a_th[req_event.top()->th_id]++;
+    req_event.pop();
   }
 
 
@@ -2625,7 +2701,6 @@ bool MemoryController::pre_processing(uint64_t curr_time)
     curr_batch_last = (int32_t)req_l.size() - 1;
     if (curr_batch_last > (int32_t)req_window_sz - 1) curr_batch_last = req_window_sz - 1;
   }
-  req_event.erase(curr_time);
 
   bool command_sent = false;
   vector<LocalQueueElement *>::iterator iter, iter2;
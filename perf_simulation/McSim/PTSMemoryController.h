@@ -644,6 +644,9 @@ namespace PinPthread
       uint64_t num_global_pred_hit;
       uint64_t accu_num_activated_bank;
       uint64_t last_call_process_event;
+      uint64_t num_activated_bank;  // banks in activate, read or write
+      bool     polling;             // a call at last_call_process_event re-added the MC
+      uint64_t bliss_event_time;    // next blacklist clearing event
 
    public:
       uint64_t num_l_pred_miss_curr;
@@ -693,12 +696,19 @@ namespace PinPthread
       uint64_t num_reqs;
       void     update_acc_dist();
 
+      // can it be simulated on a worker thread? (pts.geq.pdes)
+      bool     pdes_capable() const;
+      uint32_t min_mc_to_dir_t() const { return (mc_to_dir_t_ab < mc_to_dir_t) ? mc_to_dir_t_ab : mc_to_dir_t; }
+
     private:
       uint64_t get_page_num(uint64_t addr);
       uint64_t get_col_num(uint64_t addr);
       void show_state(uint64_t curr_time);
 
       bool     pre_processing(uint64_t curr_time);  // returns if the command was already sent or not.
+      void     set_bank_action(BankStatus & bank, mc_bank_action type);  // keeps num_activated_bank
+      uint64_t next_idle_event_time(uint64_t curr_time);
+      void     add_poll_event(uint64_t event_time);  // sets polling
       void     check_bank_status(LocalQueueElement * local_event);
 
       uint32_t num_hthreads;
@@ -148,7 +148,7 @@ void RBoL::add_req_event(
   {
     //if (num == 2) {cout << event_time << " Q " << hex << local_event->address << dec << " "; local_event->display();}
     geq->add_event(event_time, this);
-    req_event.insert(pair<uint64_t, LocalQueueElement *>(event_time, local_event));
+    req_event.push(event_time, local_event);
   }
 }
 
@@ -170,7 +170,7 @@ void RBoL::add_rep_event(
   {
     //if (num == 2) {cout << event_time << " P " << hex << local_event->address << dec << " "; local_event->display();}
     geq->add_event(event_time, this);
-    rep_event.insert(pair<uint64_t, LocalQueueElement *>(event_time, local_event));
+    rep_event.push(event_time, local_event);
   }
 }
 
@@ -178,23 +178,19 @@ void RBoL::add_rep_event(
 uint32_t RBoL::process_event(uint64_t curr_time)
 {
   list<LocalQueueElement *>::iterator iter;
-  multimap<uint64_t, LocalQueueElement *>::iterator req_event_iter = req_event.begin();
 
-  while (req_event_iter != req_event.end() && req_event_iter->first == curr_time)
+  while (req_event.ready(curr_time) == true)
   {
-    req_l.push_back(req_event_iter->second);
-    ++req_event_iter;
+    req_l.push_back(req_event.top());
+    req_event.pop();
   }
-  req_event.erase(curr_time);
 
-  multimap<uint64_t, LocalQueueElement *>::iterator rep_event_iter = rep_event.begin();
 
-  while (rep_event_iter != rep_event.end() && rep_event_iter->first == curr_time)
+  while (rep_event.ready(curr_time) == true)
   {
-    rep_l.push_back(rep_event_iter->second);
-    ++rep_event_iter;
+    rep_l.push_back(rep_event.top());
+    rep_event.pop();
   }
-  rep_event.erase(curr_time);
 
 
   if ((iter = rep_l.begin()) != rep_l.end())
@@ -348,7 +344,7 @@ uint32_t RBoL::process_event(uint64_t curr_time)
         {
           (*iter)->from.pop();
           geq->add_event(curr_time + process_interval, this);
-          req_event.insert(pair<uint64_t, LocalQueueElement *>(curr_time + process_interval, *iter));
+          req_event.push(curr_time + process_interval, *iter);
           break;
         }
       }
@@ -441,7 +437,7 @@ uint32_t RBoL::process_event(uint64_t curr_time)
         {
           (*iter)->from.pop();
           geq->add_event(curr_time + process_interval, this);
-          req_event.insert(pair<uint64_t, LocalQueueElement *>(curr_time + process_interval, *iter));
+          req_event.push(curr_time + process_interval, *iter);
           break;
         }
       }
@@ -481,7 +477,7 @@ uint32_t RBoL::process_event(uint64_t curr_time)
           {
             (*iter)->from.pop();
             geq->add_event(curr_time + process_interval, this);
-            req_event.insert(pair<uint64_t, LocalQueueElement *>(curr_time + process_interval, *iter));
+            req_event.push(curr_time + process_interval, *iter);
           }
           else
           {
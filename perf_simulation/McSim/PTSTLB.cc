@@ -79,23 +79,21 @@ void TLBL1::add_req_event(
     Component * from)
 {
   geq->add_event(event_time, this);
-  req_event.insert(pair<uint64_t, LocalQueueElement *>(event_time, local_event));
+  req_event.push(event_time, local_event);
 }
 
 
 
 uint32_t TLBL1::process_event(uint64_t curr_time)
 {
-  multimap<uint64_t, LocalQueueElement *>::iterator req_event_iter = req_event.begin();
 
   LocalQueueElement * req_lqe = NULL;
   // event -> queue
-  while (req_event_iter != req_event.end() && req_event_iter->first == curr_time)
+  while (req_event.ready(curr_time) == true)
   {
-    req_q.push(req_event_iter->second);
-    ++req_event_iter;
+    req_q.push(req_event.top());
+    req_event.pop();
   }
-  req_event.erase(curr_time);
 
 
   for (uint32_t i = 0; i < speedup; i++)
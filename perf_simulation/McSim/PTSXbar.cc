@@ -97,7 +97,7 @@ void Crossbar::add_req_event(
   num_req++;
   num_flits++;
   geq->add_event(event_time, this);
-  req_events.insert(pair<uint64_t, EventPair>(event_time, EventPair(local_event, from)));
+  req_events.push(event_time, EventPair(local_event, from));
 }
 
 
@@ -115,7 +115,7 @@ void Crossbar::add_crq_event(
   num_crq++;
   num_flits++;
   geq->add_event(event_time, this);
-  crq_events.insert(pair<uint64_t, EventPair>(event_time, EventPair(local_event, from)));
+  crq_events.push(event_time, EventPair(local_event, from));
 }
 
 
@@ -157,7 +157,7 @@ void Crossbar::add_rep_event(
   num_rep++;
   num_flits++;
   geq->add_event(event_time, this);
-  rep_events.insert(pair<uint64_t, EventPair>(event_time, EventPair(local_event, from)));
+  rep_events.push(event_time, EventPair(local_event, from));
 }
 
 
@@ -230,49 +230,41 @@ void Crossbar::add_dirrq_event(
 
 uint32_t Crossbar::process_event(uint64_t curr_time)
 {
-  std::multimap<uint64_t, EventPair>::iterator req_event_iter = req_events.begin();
-  std::multimap<uint64_t, EventPair>::iterator rep_event_iter = rep_events.begin();
-  std::multimap<uint64_t, EventPair>::iterator crq_event_iter = crq_events.begin();
-
-  while (rep_event_iter != rep_events.end() && rep_event_iter->first == curr_time)
+  while (rep_events.ready(curr_time) == true)
   {
-    if (rep_event_iter->second.first->type == et_evict ||
-        rep_event_iter->second.first->type == et_evict_owned ||
-        rep_event_iter->second.first->type == et_invalidate ||
-        rep_event_iter->second.first->type == et_invalidate_nd ||
-        rep_event_iter->second.first->type == et_nop ||
-        rep_event_iter->second.first->type == et_e_to_i ||
-        rep_event_iter->second.first->type == et_e_to_m)
+    if (rep_events.top().first->type == et_evict ||
+        rep_events.top().first->type == et_evict_owned ||
+        rep_events.top().first->type == et_invalidate ||
+        rep_events.top().first->type == et_invalidate_nd ||
+        rep_events.top().first->type == et_nop ||
+        rep_events.top().first->type == et_e_to_i ||
+        rep_events.top().first->type == et_e_to_m)
     {
-      uint32_t which_mc = geq->which_mc(rep_event_iter->second.first->address);
-      queues[rep_event_iter->second.second->num].insert(std::pair<noc_priority, EventPair>(noc_rep, EventPair(rep_event_iter->second.first, directory[which_mc])));
+      uint32_t which_mc = geq->which_mc(rep_events.top().first->address);
+      queues[rep_events.top().second->num].insert(std::pair<noc_priority, EventPair>(noc_rep, EventPair(rep_events.top().first, directory[which_mc])));
     }
     else
     {
-      queues[rep_event_iter->second.second->num].insert(std::pair<noc_priority, EventPair>(noc_rep, EventPair(rep_event_iter->second.first, rep_event_iter->second.first->from.top())));
+      queues[rep_events.top().second->num].insert(std::pair<noc_priority, EventPair>(noc_rep, EventPair(rep_events.top().first, rep_events.top().first->from.top())));
     }
-    ++rep_event_iter;
+    rep_events.pop();
   }
 
-  while (crq_event_iter != crq_events.end() && crq_event_iter->first == curr_time)
+  while (crq_events.ready(curr_time) == true)
   {
     // special case --  from.top() is the target L2
-    queues[crq_event_iter->second.second->num].insert(std::pair<noc_priority, EventPair>(noc_crq, EventPair(crq_event_iter->second.first, crq_event_iter->second.first->from.top())));
-    crq_event_iter->second.first->from.pop();
-    ++crq_event_iter;
+    queues[crq_events.top().second->num].insert(std::pair<noc_priority, EventPair>(noc_crq, EventPair(crq_events.top().first, crq_events.top().first->from.top())));
+    crq_events.top().first->from.pop();
+    crq_events.pop();
   }
 
-  while (req_event_iter != req_events.end() && req_event_iter->first == curr_time)
+  while (req_events.ready(curr_time) == true)
   {
     // process the first request event
-    uint32_t which_mc  = geq->which_mc(req_event_iter->second.first->address);  // TODO : it is assumed that (directory[i]->num == i)
-    queues[req_event_iter->second.second->num].insert(std::pair<noc_priority, EventPair>(noc_req, EventPair(req_event_iter->second.first, directory[which_mc])));
-    ++req_event_iter;
+    uint32_t which_mc  = geq->which_mc(req_events.top().first->address);  // TODO : it is assumed that (directory[i]->num == i)
+    queues[req_events.top().second->num].insert(std::pair<noc_priority, EventPair>(noc_req, EventPair(req_events.top().first, directory[which_mc])));
+    req_events.pop();
   }
-  
-  req_events.erase(curr_time);  // add_req_event
-  crq_events.erase(curr_time);  // add_rep_event
-  rep_events.erase(curr_time);  // add_rep_event
 
 
   // send events to destinations
@@ -369,9 +361,9 @@ Mesh2D::Mesh2D(
   sw_to_sw_t(get_param_uint64("sw_to_sw_t", 10)),
   num_rows  (get_param_uint64("num_rows", 4)),
   num_cols  (get_param_uint64("num_cols", 2)),
-  req_qs(num_rows, vector< vector< multimap<uint64_t, EventPair> > >(num_cols, vector< multimap<uint64_t, EventPair> >(mesh_invalid))),
-  crq_qs(num_rows, vector< vector< multimap<uint64_t, EventPair> > >(num_cols, vector< multimap<uint64_t, EventPair> >(mesh_invalid))),
-  rep_qs(num_rows, vector< vector< multimap<uint64_t, EventPair> > >(num_cols, vector< multimap<uint64_t, EventPair> >(mesh_invalid))),
+  req_qs(num_rows, vector< vector< TimedQueue<EventPair> > >(num_cols, vector< TimedQueue<EventPair> >(mesh_invalid))),
+  crq_qs(num_rows, vector< vector< TimedQueue<EventPair> > >(num_cols, vector< TimedQueue<EventPair> >(mesh_invalid))),
+  rep_qs(num_rows, vector< vector< TimedQueue<EventPair> > >(num_cols, vector< TimedQueue<EventPair> >(mesh_invalid))),
   already_sent(mesh_invalid),
   token(0), num_hops(0), num_hops2(0)
 {
@@ -438,7 +430,7 @@ void Mesh2D::add_req_event(
   uint32_t col = cluster_num % num_cols;
   uint32_t row = cluster_num / num_cols;
 
-  req_qs[row][col][mesh_cluster].insert(pair<uint64_t, EventPair>(event_time, EventPair(local_event, from)));
+  req_qs[row][col][mesh_cluster].push(event_time, EventPair(local_event, from));
   ++num_req_in_mesh;
   ++num_req;
   num_flits++;
@@ -463,7 +455,7 @@ void Mesh2D::add_crq_event(
   uint32_t col = mc_pos[mc_num] % num_cols;
   uint32_t row = mc_pos[mc_num] / num_cols;
 
-  crq_qs[row][col][mesh_directory].insert(pair<uint64_t, EventPair>(event_time, EventPair(local_event, from)));
+  crq_qs[row][col][mesh_directory].push(event_time, EventPair(local_event, from));
   ++num_req_in_mesh;
   ++num_crq;
   num_flits++;
@@ -524,7 +516,7 @@ void Mesh2D::add_rep_event(
     col = cluster_num % num_cols;
     row = cluster_num / num_cols;
 
-    rep_qs[row][col][mesh_cluster].insert(pair<uint64_t, EventPair>(event_time, EventPair(local_event, from)));
+    rep_qs[row][col][mesh_cluster].push(event_time, EventPair(local_event, from));
   }
   else
   {
@@ -532,7 +524,7 @@ void Mesh2D::add_rep_event(
     col = mc_pos[mc_num] % num_cols;
     row = mc_pos[mc_num] / num_cols;
 
-    rep_qs[row][col][mesh_directory].insert(pair<uint64_t, EventPair>(event_time, EventPair(local_event, from)));
+    rep_qs[row][col][mesh_directory].push(event_time, EventPair(local_event, from));
   }
   ++num_req_in_mesh;
   ++num_rep;
@@ -657,7 +649,7 @@ void Mesh2D::process_qs(
     uint32_t dir,
     uint64_t curr_time)
 {
-  vector< vector< vector< multimap<uint64_t, EventPair > > > > * curr_qs;
+  vector< vector< vector< TimedQueue<EventPair> > > > * curr_qs;
   Directory * to_dir = NULL;
   CacheL2   * to_l2  = NULL;
   uint32_t  col, row;
@@ -676,11 +668,11 @@ void Mesh2D::process_qs(
   }
   
   if ((*curr_qs)[i][j][dir].empty() == true ||
-      (*curr_qs)[i][j][dir].begin()->first > curr_time)
+      (*curr_qs)[i][j][dir].top_time() > curr_time)
   {
     return;
   }
-  EventPair curr_q = (*curr_qs)[i][j][dir].begin()->second;
+  EventPair curr_q = (*curr_qs)[i][j][dir].top();
   switch (queue_type)
   {
     case noc_rep:
@@ -736,7 +728,7 @@ void Mesh2D::process_qs(
       return;
     }
     already_sent[mesh_west] = true;
-    (*curr_qs)[i][j-1][mesh_east].insert(pair<uint64_t, EventPair>(curr_time + sw_to_sw_t, curr_q));
+    (*curr_qs)[i][j-1][mesh_east].push(curr_time + sw_to_sw_t, curr_q);
   }
   else if (j < col)
   {
@@ -745,7 +737,7 @@ void Mesh2D::process_qs(
       return;
     }
     already_sent[mesh_east] = true;
-    (*curr_qs)[i][j+1][mesh_west].insert(pair<uint64_t, EventPair>(curr_time + sw_to_sw_t, curr_q));
+    (*curr_qs)[i][j+1][mesh_west].push(curr_time + sw_to_sw_t, curr_q);
   }
   else if (i > row)
   {
@@ -754,7 +746,7 @@ void Mesh2D::process_qs(
       return;
     }
     already_sent[mesh_north] = true;
-    (*curr_qs)[i-1][j][mesh_south].insert(pair<uint64_t, EventPair>(curr_time + sw_to_sw_t, curr_q));
+    (*curr_qs)[i-1][j][mesh_south].push(curr_time + sw_to_sw_t, curr_q);
   }
   else if (i < row)
   {
@@ -763,7 +755,7 @@ void Mesh2D::process_qs(
       return;
     }
     already_sent[mesh_south] = true;
-    (*curr_qs)[i+1][j][mesh_north].insert(pair<uint64_t, EventPair>(curr_time + sw_to_sw_t, curr_q));
+    (*curr_qs)[i+1][j][mesh_north].push(curr_time + sw_to_sw_t, curr_q);
   }
   else
   {
@@ -820,7 +812,7 @@ void Mesh2D::process_qs(
       num_req_in_mesh--;
     }
   }
-  (*curr_qs)[i][j][dir].erase((*curr_qs)[i][j][dir].begin());
+  (*curr_qs)[i][j][dir].pop();
   num_hops++;
 }
 
@@ -916,13 +908,13 @@ Ring::Ring(
 //  already_sent = vector<bool>(max_radix, false);
   already_sent = vector<uint32_t>(max_radix, num_paths);
   num_residual_path = vector<uint32_t>(max_radix, num_paths);
-  req_qs = vector< vector< multimap<uint64_t, EventPair> > >(num_nodes, vector< multimap<uint64_t, EventPair> >(max_radix));
-  crq_qs = vector< vector< multimap<uint64_t, EventPair> > >(num_nodes, vector< multimap<uint64_t, EventPair> >(max_radix));
-  rep_qs = vector< vector< multimap<uint64_t, EventPair> > >(num_nodes, vector< multimap<uint64_t, EventPair> >(max_radix));
-  l3rq_qs = vector< vector< multimap<uint64_t, EventPair> > >(num_nodes, vector< multimap<uint64_t, EventPair> >(max_radix));
-  l3rp_qs = vector< vector< multimap<uint64_t, EventPair> > >(num_nodes, vector< multimap<uint64_t, EventPair> >(max_radix));
-  mcrp_qs = vector< vector< multimap<uint64_t, EventPair> > >(num_nodes, vector< multimap<uint64_t, EventPair> >(max_radix));
-  dirrq_qs = vector< vector< multimap<uint64_t, EventPair> > >(num_nodes, vector< multimap<uint64_t, EventPair> >(max_radix)); 
+  req_qs = vector< vector< TimedQueue<EventPair> > >(num_nodes, vector< TimedQueue<EventPair> >(max_radix));
+  crq_qs = vector< vector< TimedQueue<EventPair> > >(num_nodes, vector< TimedQueue<EventPair> >(max_radix));
+  rep_qs = vector< vector< TimedQueue<EventPair> > >(num_nodes, vector< TimedQueue<EventPair> >(max_radix));
+  l3rq_qs = vector< vector< TimedQueue<EventPair> > >(num_nodes, vector< TimedQueue<EventPair> >(max_radix));
+  l3rp_qs = vector< vector< TimedQueue<EventPair> > >(num_nodes, vector< TimedQueue<EventPair> >(max_radix));
+  mcrp_qs = vector< vector< TimedQueue<EventPair> > >(num_nodes, vector< TimedQueue<EventPair> >(max_radix));
+  dirrq_qs = vector< vector< TimedQueue<EventPair> > >(num_nodes, vector< TimedQueue<EventPair> >(max_radix)); 
 }
 
 
@@ -952,7 +944,7 @@ void Ring::add_req_event(
   uint32_t cluster_pos      = l2_pos[cluster_num];
   uint32_t cluster_port_num = l2_port_num[cluster_num];
 
-  req_qs[cluster_pos][cluster_port_num].insert(pair<uint64_t, EventPair>(event_time, EventPair(local_event, from)));
+  req_qs[cluster_pos][cluster_port_num].push(event_time, EventPair(local_event, from));
   ++num_req_in_ring;
 
   ++num_req;
@@ -989,8 +981,8 @@ void Ring::add_crq_event(
     directory_pos = mc_pos[directory_num];
     directory_port_num = mc_port_num[directory_num];
   }
-  crq_qs[directory_pos][directory_port_num].insert(pair<uint64_t, EventPair>(event_time, EventPair(local_event, from)));
-  //  crq_qs[dir_pos][dir_port_num].insert(pair<uint64_t, EventPair>(event_time, EventPair(local_event, from)));
+  crq_qs[directory_pos][directory_port_num].push(event_time, EventPair(local_event, from));
+  //  crq_qs[dir_pos][dir_port_num].push(event_time, EventPair(local_event, from));
   ++num_req_in_ring;
   ++num_crq;
   num_flits++;
@@ -1050,7 +1042,7 @@ void Ring::add_rep_event(
     uint32_t cluster_pos      = l2_pos[cluster_num];
     uint32_t cluster_port_num = l2_port_num[cluster_num];
 
-    rep_qs[cluster_pos][cluster_port_num].insert(pair<uint64_t, EventPair>(event_time, EventPair(local_event, from)));
+    rep_qs[cluster_pos][cluster_port_num].push(event_time, EventPair(local_event, from));
   }
   else
   {
@@ -1069,8 +1061,8 @@ void Ring::add_rep_event(
       directory_pos = mc_pos[directory_num];
       directory_port_num = mc_port_num[directory_num];
     }
-    rep_qs[directory_pos][directory_port_num].insert(pair<uint64_t, EventPair>(event_time, EventPair(local_event, from)));
-    //    rep_qs[dir_pos][dir_port_num].insert(pair<uint64_t, EventPair>(event_time, EventPair(local_event, from)));
+    rep_qs[directory_pos][directory_port_num].push(event_time, EventPair(local_event, from));
+    //    rep_qs[dir_pos][dir_port_num].push(event_time, EventPair(local_event, from));
   }
   ++num_req_in_ring;
   ++num_rep;
@@ -1114,7 +1106,7 @@ void Ring::add_l3rq_event(
   uint32_t cluster_pos      = l3_pos[cluster_num];
   uint32_t cluster_port_num = l3_port_num[cluster_num];
 
-  l3rq_qs[cluster_pos][cluster_port_num].insert(pair<uint64_t, EventPair>(event_time, EventPair(local_event, from)));
+  l3rq_qs[cluster_pos][cluster_port_num].push(event_time, EventPair(local_event, from));
   ++num_req_in_ring;
 
   ++num_l3rq;
@@ -1137,7 +1129,7 @@ void Ring::add_l3rp_event(
   uint32_t cluster_pos      = l3_pos[cluster_num];
   uint32_t cluster_port_num = l3_port_num[cluster_num];
 
-  l3rp_qs[cluster_pos][cluster_port_num].insert(pair<uint64_t, EventPair>(event_time, EventPair(local_event, from)));
+  l3rp_qs[cluster_pos][cluster_port_num].push(event_time, EventPair(local_event, from));
   ++num_req_in_ring;
 
   ++num_l3rp;
@@ -1183,7 +1175,7 @@ void Ring::add_mcrp_event(
   uint32_t memorycontroller_pos = mc_pos[mc_num];
   uint32_t memorycontroller_port_num = mc_port_num[mc_num];
 
-  mcrp_qs[memorycontroller_pos][memorycontroller_port_num].insert(pair<uint64_t, EventPair>(event_time, EventPair(local_event, from)));
+  mcrp_qs[memorycontroller_pos][memorycontroller_port_num].push(event_time, EventPair(local_event, from));
   ++num_req_in_ring;
 
   ++num_mcrp;
@@ -1228,7 +1220,7 @@ void Ring::add_dirrq_event(
   uint32_t directory_pos = dir_pos[directory_num];
   uint32_t directory_port_num = dir_port_num[directory_num];
 
-  dirrq_qs[directory_pos][directory_port_num].insert(pair<uint64_t, EventPair>(event_time, EventPair(local_event, from)));
+  dirrq_qs[directory_pos][directory_port_num].push(event_time, EventPair(local_event, from));
   ++num_req_in_ring;
 
   ++num_dirrq;
@@ -1285,7 +1277,7 @@ void Ring::process_qs(
     uint32_t dir,
     uint64_t curr_time)
 {
-  vector< vector< multimap<uint64_t, EventPair > > > * curr_qs;
+  vector< vector< TimedQueue<EventPair> > > * curr_qs;
   Directory * to_dir = NULL;
   CacheL2   * to_l2  = NULL;
   Component * to_MC  = NULL;
@@ -1321,11 +1313,11 @@ void Ring::process_qs(
   while (num_residual_path[dir] > 0)
   {
     if ((*curr_qs)[i][dir].empty() == true ||
-        (*curr_qs)[i][dir].begin()->first > curr_time)
+        (*curr_qs)[i][dir].top_time() > curr_time)
     {
       return;
     }
-    EventPair curr_q = (*curr_qs)[i][dir].begin()->second;
+    EventPair curr_q = (*curr_qs)[i][dir].top();
     to_dir = NULL;
     to_l2 = NULL;
     to_MC = NULL;
@@ -1441,7 +1433,7 @@ void Ring::process_qs(
       already_sent[ring_cw]--;
       num_residual_path[dir]--;
       uint32_t router_pos = (i + 1) % num_nodes;
-      (*curr_qs)[router_pos][ring_ccw].insert(pair<uint64_t, EventPair>(curr_time + sw_to_sw_t, curr_q));
+      (*curr_qs)[router_pos][ring_ccw].push(curr_time + sw_to_sw_t, curr_q);
     }
     else if (target_pos != i)
     {
@@ -1453,7 +1445,7 @@ void Ring::process_qs(
       already_sent[ring_ccw]--;
       num_residual_path[dir]--;
       uint32_t router_pos = (num_nodes + i - 1) % num_nodes;
-      (*curr_qs)[router_pos][ring_cw].insert(pair<uint64_t, EventPair>(curr_time + sw_to_sw_t, curr_q));
+      (*curr_qs)[router_pos][ring_cw].push(curr_time + sw_to_sw_t, curr_q);
     }
     else
     {
@@ -1552,7 +1544,7 @@ void Ring::process_qs(
 //        curr_q.first->from.pop();
 //      }
     }
-    (*curr_qs)[i][dir].erase((*curr_qs)[i][dir].begin());
+    (*curr_qs)[i][dir].pop();
     num_hops++;
   }
 }
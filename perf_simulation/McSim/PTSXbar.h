@@ -78,9 +78,9 @@ namespace PinPthread
 
       // not sure if req_queue and rep_queue are enough to avoid deadlock (due to
       // circular dependency with finite buffer size) or more queues are necessary.
-      std::multimap<uint64_t, EventPair> crq_events;  // <event, from>
-      std::multimap<uint64_t, EventPair> req_events;
-      std::multimap<uint64_t, EventPair> rep_events;
+      TimedQueue<EventPair> crq_events;  // <event, from>
+      TimedQueue<EventPair> req_events;
+      TimedQueue<EventPair> rep_events;
       std::vector< std::multimap<noc_priority, EventPair> > queues;  // <event, to>
       std::vector<bool> already_sent;
 
@@ -137,9 +137,9 @@ namespace PinPthread
       uint32_t num_cols;
 
       // [row][col][dir]
-      vector< vector< vector< multimap<uint64_t, EventPair> > > > req_qs;
-      vector< vector< vector< multimap<uint64_t, EventPair> > > > crq_qs;
-      vector< vector< vector< multimap<uint64_t, EventPair> > > > rep_qs;
+      vector< vector< vector< TimedQueue<EventPair> > > > req_qs;
+      vector< vector< vector< TimedQueue<EventPair> > > > crq_qs;
+      vector< vector< vector< TimedQueue<EventPair> > > > rep_qs;
 
       vector<bool> already_sent;
       uint32_t     token;
@@ -201,13 +201,13 @@ namespace PinPthread
       uint64_t num_paths; // for shared_LLC
       bool     is_simple_ring; // for shared_LLC
       // [ring][dir]
-      vector< vector< multimap<uint64_t, EventPair> > > req_qs;
-      vector< vector< multimap<uint64_t, EventPair> > > crq_qs;
-      vector< vector< multimap<uint64_t, EventPair> > > rep_qs;
-      vector< vector< multimap<uint64_t, EventPair> > > l3rq_qs;
-      vector< vector< multimap<uint64_t, EventPair> > > l3rp_qs;
-      vector< vector< multimap<uint64_t, EventPair> > > mcrp_qs;
-      vector< vector< multimap<uint64_t, EventPair> > > dirrq_qs;
+      vector< vector< TimedQueue<EventPair> > > req_qs;
+      vector< vector< TimedQueue<EventPair> > > crq_qs;
+      vector< vector< TimedQueue<EventPair> > > rep_qs;
+      vector< vector< TimedQueue<EventPair> > > l3rq_qs;
+      vector< vector< TimedQueue<EventPair> > > l3rp_qs;
+      vector< vector< TimedQueue<EventPair> > > mcrp_qs;
+      vector< vector< TimedQueue<EventPair> > > dirrq_qs;
 
       vector<uint32_t> already_sent;
       vector<uint32_t> num_residual_path;
@@ -13,7 +13,7 @@ else
   OPT = -O3 -g -Wno-nonnull
 endif
 
-CXXFLAGS = -Wno-unknown-pragmas $(DBG) $(OPT) -std=c++11
+CXXFLAGS = -Wno-unknown-pragmas $(DBG) $(OPT) -std=c++11 -pthread
 CXX = g++ -DTARGET_IA32E
 CC  = gcc -DTARGET_IA32E
 
@@ -11,6 +11,16 @@
 #include <math.h>
 #include <cstring>
 #include <fstream>
+#include <stdint.h>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <deque>
+#include <chrono>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#include "Fault_sim_tables.h" // table data (generated by make from inputs/, see scripts/gen_tables.sh)
 
 
 
@@ -26,7 +36,8 @@
 #define OECC_CW_LEN 64 // AMD, QPC OECC codeword length (bit)
 #define OOC_OECC_CW_LEN 32 // OOC codeword length (bit)
 #define OECC_DATA_LEN 64 // OECC dataward length (bit)
-#define OECC_REDUN_LEN 4 // OECC redundancy length (bit)
+#define OECC_REDUN_LEN 8 // OECC redundancy length (bit)
+#define OECC_H_CW_LEN 136 // columns of inputs/H_Matrix_OECC.txt ((136,128) SEC code, check bits last)
 
 
 #define RECC_CW_LEN 80 // RL-ECC codeword length
@@ -44,8 +55,27 @@
 #define QPC_CW_SYMBOL_NUM 40 // QPC ecc codeword length (symbol) -> optional use
 #define OOC_CW_SYMBOL_NUM 80 // OOC ecc codeword length (symbol) -> optional use
 
-
-#define RUN_NUM 100000 // iteration
+// Packed chip layout: one uint64_t per chip, bit position 'pos' (0~63) is stored at bit (63-pos),
+// so the 8-bit symbol made of positions 8j~8j+7 (MSB first) is byte j counted from the MSB.
+#define BIT_MASK(pos) (1ULL << (OECC_CW_LEN-1-(pos)))
+#define SYMBOL_MASK(symbol_index) (0xFF00000000000000ULL >> (SYMBOL_SIZE*(symbol_index)))
+#define OOC_CHIP_MASK 0xFFFFFFFF00000000ULL // OOC chips only use positions 0~31
+
+
+#define RUN_NUM 100000 // iteration (default of --runs)
+#define CHECK_INTERVAL 100000 // iterations between convergence checks (default of --check-interval)
+#define CONFIDENCE 0.95 // confidence level of the reported intervals (default of --confidence)
+#define IS_BIAS_MAX 0.9 // importance sampling : max. --is-bias (keeps w^2 sums in range)
+#define IS_WEIGHT_SCALE 1099511627776.0 // 2^40 : importance weights are summed in fixed point (same sums at any thread count)
+#define SWEEP_CHUNK 10000 // trials per work item in sweep mode (--sweep)
+#define STATS_SAMPLE 64 // 1 in STATS_SAMPLE trials is timed per stage (--stats, power of 2)
+#define LIFETIME_YEARS 7 // service life (default of --years, --lifetime)
+#define SCRUB_HOURS 24 // patrol scrub interval (default of --scrub-hours, --lifetime)
+#define HOURS_PER_YEAR 8766.0
+#define ROW_ACCESS_NUM 128 // 64B accesses (codewords) per DRAM row (ROWHAMMER, --lifetime columns)
+#define RANK_BANK_NUM 32 // banks per rank (--lifetime fault footprints)
+#define BANK_ROW_NUM 65536 // rows per bank (--lifetime fault footprints)
+#define RH_FLIP_PROB 1e-4 // flip probability of a susceptible cell (default of --rh-flip, ROWHAMMER)
 
 
 #define CONSERVATIVE_MODE 1 // 1: Conservavie mode, 0: Restrained mode
@@ -59,6 +89,8 @@
 #define QPC_tt  4           /* number of errors that can be corrected */
 #define QPC_kk  247           /* kk = nn-2*tt  */
 #define QPC_nn_short  40      /* length of codeword (shortened) */
+#define RS_tt_MAX OOC_tt // max. t of a codec (rs_syndrome_lane : s1~s16)
+#define RS_nn_short_MAX OOC_nn_short // max. n_short of a codec (rs_syndrome_lane : symbols 0~79)
 //----------------------------------
 
 // Configuration end
@@ -66,67 +98,88 @@
 
 
 using namespace std;
-unsigned int H_Matrix_OECC[OECC_REDUN_LEN][OECC_CW_LEN]; // 8 x 64
+constexpr unsigned int H_Matrix_OECC[OECC_REDUN_LEN][OECC_H_CW_LEN]={H_MATRIX_OECC_ROWS}; // 8 x 136
+static_assert(H_MATRIX_OECC_ROW_NUM==OECC_REDUN_LEN && H_MATRIX_OECC_COLUMN_NUM==OECC_H_CW_LEN, "H matrix file : expected OECC_REDUN_LEN rows of OECC_H_CW_LEN columns");
 unsigned int H_Matrix_RECC[RECC_REDUN_LEN][RECC_CW_LEN]; // 8 x 40
 
-unsigned int primitive_poly[16][256]={0,}; // primitive polynomial (ex : primitive_poly[4][254] = a^254, primitive_poly[4][255] = 0 (prim_num=4, primitive_poly = x^8+x^6+x^4+x^3+x^2+x^1+1))
 enum OECC_TYPE {OECC_OFF=0, OECC_ON=1}; // oecc_type
-enum FAULT_TYPE {SBE=0, PIN_1=1, SCE=2, DBE=3, TBE=4, SCE_SBE=5, SCE_DBE=6, SCE_SCE=7, RANK=8};
+enum FAULT_TYPE {SBE=0, PIN_1=1, SCE=2, DBE=3, TBE=4, SCE_SBE=5, SCE_DBE=6, SCE_SCE=7, RANK=8, ROWHAMMER=9};
 enum RECC_TYPE {RECC_OFF=0, AMDCHIPKILL=1, QPC=2, OOC=3}; // recc_type
 enum RESULT_TYPE {NE=0, CE=1, DUE=2, SDC=3}; // result_type
 
 
-unsigned int getAbit(unsigned short x, int n) { 
-  return (x & (1 << n)) >> n;
+// 8-bit symbol 'symbol_index' (0~7) of a packed chip word
+inline unsigned int get_symbol(uint64_t word, int symbol_index) {
+  return (unsigned int)(word >> (OECC_CW_LEN-SYMBOL_SIZE*(symbol_index+1))) & 0xFF;
 }
 
 
-unsigned int conversion_to_int_format(char *str_read, int m)
+// Dirty chip mask : bit i is set once chip i may hold an error, so a trial only clears, gathers
+// and checks the chips its faults touched. Chip_array is all zero outside the dirty chips.
+// zero the dirty chips of the previous trial (instead of the whole array)
+inline void clear_chips(uint64_t *Chip_array, uint32_t *dirty)
 {
-    unsigned int primitive_value=0;
-    if(strstr(str_read,"^7")!=NULL)
-        primitive_value+=int(pow(2,7));
-    if(strstr(str_read,"^6")!=NULL)
-        primitive_value+=int(pow(2,6));
-    if(strstr(str_read,"^5")!=NULL)
-        primitive_value+=int(pow(2,5));
-    if(strstr(str_read,"^4")!=NULL)
-        primitive_value+=int(pow(2,4));
-    if(strstr(str_read,"^3")!=NULL)
-        primitive_value+=int(pow(2,3));
-    if(strstr(str_read,"^2")!=NULL)
-        primitive_value+=int(pow(2,2));
-    if(strstr(str_read,"^1+")!=NULL) 
-        primitive_value+=int(pow(2,1));
-    if(strstr(str_read,"+1")!=NULL)
-        primitive_value+=int(pow(2,0));
-    
-
-    return primitive_value;
+    for(uint32_t mask=*dirty; mask; mask&=mask-1)
+        Chip_array[__builtin_ctz(mask)]=0;
+    *dirty=0;
 }
 
 
-// primitive polynomial table 
-void generate_primitive_poly(unsigned int prim_value, int m, int prim_num)
+// Rank-level RS code over the packed chips :
+//   TT           : correctable symbols
+//   CHIPS        : chips per codeword
+//   CHIP_SYMBOLS : symbols of a chip in one codeword (chip c holds symbols c*CHIP_SYMBOLS ~ (c+1)*CHIP_SYMBOLS-1)
+//   BLOCKS       : codewords per access (block b : the block_bits bit positions from block_bits*b of every chip)
+//   SPREAD_TT    : more than SPREAD_TT symbol errors are only corrected within one chip group
+//   GROUP_CHIPS  : chips c, c' are in the same group when c%GROUP_CHIPS == c'%GROUP_CHIPS
+// The symbol size is not a parameter : every codec uses SYMBOL_SIZE-bit symbols over the GF(2^8) tables.
+template<int TT, int CHIPS, int CHIP_SYMBOLS, int BLOCKS, int SPREAD_TT, int GROUP_CHIPS>
+struct RS_codec {
+    static const int tt=TT, chip_num=CHIPS, chip_symbols=CHIP_SYMBOLS, block_num=BLOCKS, spread_tt=SPREAD_TT, group_chips=GROUP_CHIPS;
+    static const int block_bits=CHIP_SYMBOLS*SYMBOL_SIZE; // bits of a chip word in one codeword
+    static const int n_short=CHIPS*CHIP_SYMBOLS;
+    static const int syndrome_word_num=(2*TT+7)/8; // 8 syndromes per 64-bit word
+    static_assert(TT<=RS_tt_MAX && n_short<=RS_nn_short_MAX, "RS_codec : code exceeds rs_syndrome_lane");
+    static_assert(BLOCKS*block_bits<=OECC_CW_LEN && CHIPS<=32, "RS_codec : blocks exceed the chip words");
+
+    // positions of block 'block' in a chip word
+    static constexpr uint64_t block_mask(int block) { return (~0ULL << (OECC_CW_LEN-block_bits)) >> (block_bits*block); }
+};
+
+// AMDCHIPKILL is not an RS_codec : one symbol per chip and codeword (8 codewords per access), decoded with
+// its own syndrome tables (see amd_syndrome_lanes)
+typedef RS_codec<OOC_tt, OOC_CHIP_NUM, 4, 1, 4, 10> OOC_codec; // > 4 errors : chip pair (chip, chip+10) only
+typedef RS_codec<QPC_tt, CHIP_NUM, 4, 2, 2, CHIP_NUM> QPC_codec; // > 2 errors : single chip only
+static_assert(OOC_codec::block_mask(0)==OOC_CHIP_MASK, "OOC_codec : the codeword is the OOC chip word");
+
+
+// gather the symbols of codeword 'block' (chip c : symbols c*chip_symbols ~, MSB first) of the dirty chips
+template<class Codec>
+void gather_codeword(const uint64_t *Chip_array, uint32_t dirty, int block, unsigned int *codeword)
 {
-    unsigned int value = 0x1; // start value (0000 0001)
-    int total_count = int(pow(2,m));
-    int count=0;
-    while (count<total_count-1){ // count : 0~254
-        primitive_poly[prim_num][count]=value;
-        if(value>=0x80){ 
-            value=value<<(32-m+1);
-            value=value>>(32-m);
-
-            value=value^prim_value;
-        }
-        else 
-            value=value<<1;
-        
-        count++;
+    memset(codeword, 0, sizeof(unsigned int)*Codec::n_short);
+    for(uint32_t mask=dirty; mask; mask&=mask-1){
+        int Chip_idx=__builtin_ctz(mask);
+        uint64_t word = Chip_array[Chip_idx] << (Codec::block_bits*block);
+        for(int symbol=0; symbol<Codec::chip_symbols; symbol++)
+            codeword[Chip_idx*Codec::chip_symbols+symbol] = get_symbol(word, symbol);
     }
+}
 
-    return;
+
+// scatter the (corrected) symbols back into the same positions of each chip word
+// (the decoders only clear symbols, so clean chips stay clean)
+template<class Codec>
+void scatter_codeword(uint64_t *Chip_array, uint32_t dirty, int block, const unsigned int *codeword)
+{
+    uint64_t keep_mask = ~Codec::block_mask(block);
+    for(uint32_t mask=dirty; mask; mask&=mask-1){
+        int Chip_idx=__builtin_ctz(mask);
+        uint64_t word=0;
+        for(int symbol=0; symbol<Codec::chip_symbols; symbol++)
+            word |= (uint64_t)codeword[Chip_idx*Codec::chip_symbols+symbol] << (OECC_CW_LEN-SYMBOL_SIZE*(symbol+1));
+        Chip_array[Chip_idx] = (Chip_array[Chip_idx] & keep_mask) | (word >> (Codec::block_bits*block));
+    }
 }
 
 
@@ -182,6 +235,10 @@ void oecc_recc_fault_type_assignment(string &OECC, string &FAULT, string &RECC,
             FAULT.replace(FAULT.begin(), FAULT.end(),"RANK");
             *fault_type=RANK;
             break;                                
+        case ROWHAMMER:
+            FAULT.replace(FAULT.begin(), FAULT.end(),"ROWHAMMER");
+            *fault_type=ROWHAMMER;
+            break;
         default:
             break;
     }    
@@ -210,1290 +267,2630 @@ void oecc_recc_fault_type_assignment(string &OECC, string &FAULT, string &RECC,
 }
 
 
-unsigned int index_of(unsigned int value){
-    unsigned int p;
-    if (value == 0){
-        return -1;
-    }
-    for(int prim_exponent=0; prim_exponent<255; prim_exponent++){
-        if(value==primitive_poly[0][prim_exponent])
-            p=prim_exponent;
+/*------------------------------------------------------------------
+                        GF(2^8) arithmetic
+-------------------------------------------------------------------*/
+// All tables are constexpr : the compiler builds them from the table data (Fault_sim_tables.h),
+// so startup reads no file and lookups with constant indices fold into the decoders.
+// A table is a struct (arrays are filled in a constexpr function), used through a reference to its array.
+
+// primitive polynomials (without D^8, ex) 0x1D = D^8+D^4+D^3+D^2+1) -> a^0 ~ a^254 of each one
+// (ex : primitive_poly[4][254] = a^254, primitive_poly[4][255] = 0 (prim_num=4, primitive_poly = x^8+x^6+x^4+x^3+x^2+x^1+1))
+constexpr unsigned int primitive_poly_value[]={GF_PRIMITIVE_POLY_LIST};
+constexpr int PRIMITIVE_POLY_NUM=sizeof(primitive_poly_value)/sizeof(primitive_poly_value[0]);
+
+struct Primitive_poly_table {
+    unsigned int power[PRIMITIVE_POLY_NUM][256];
+};
+
+constexpr Primitive_poly_table generate_primitive_poly()
+{
+    Primitive_poly_table table{};
+    for(int prim_num=0; prim_num<PRIMITIVE_POLY_NUM; prim_num++){
+        unsigned int value = 0x1; // start value (0000 0001)
+        for(int count=0; count<nn; count++){ // count : 0~254
+            table.power[prim_num][count]=value;
+            if(value>=0x80)
+                value=((value<<1) & 0xFF) ^ primitive_poly_value[prim_num];
+            else
+                value=value<<1;
         }
-    return p;   
+    }
+    return table;
 }
 
+constexpr Primitive_poly_table primitive_poly_table=generate_primitive_poly();
+constexpr const unsigned int (&primitive_poly)[PRIMITIVE_POLY_NUM][256]=primitive_poly_table.power;
 
-// SE injection (Single Error injection)
-void error_injection_SE(int Fault_Chip_position_, unsigned int Chip_array[][OECC_CW_LEN], int recc_type)
+// a^0 ~ a^254 are the 255 nonzero elements (a log table exists)
+constexpr bool is_primitive(int prim_num)
 {
+    bool seen[nn+1]={};
+    for(int exponent=0; exponent<nn; exponent++){
+        unsigned int value=primitive_poly[prim_num][exponent];
+        if(value==0 || seen[value])
+            return false;
+        seen[value]=true;
+    }
+    return true;
+}
 
-    if (recc_type==OOC){
-        int Fault_Chip_position = rand() % OOC_CHIP_NUM;
-        int Fault_bit_position = rand() % OOC_OECC_CW_LEN;
 
-        Chip_array[Fault_Chip_position][Fault_bit_position]=1;
-        return;
+// gf_alpha_to[i] = a^i (antilog), stored twice so that a sum of two exponents needs no modulo
+// gf_index_of[x] = log_a(x) (x: 1~255), gf_index_of[0] = -1
+struct GF_table {
+    int alpha_to[2*nn];
+    int index_of[nn+1];
+};
+
+// log/antilog tables of a primitive polynomial
+constexpr GF_table generate_gf_table(int prim_num)
+{
+    GF_table table{};
+    table.index_of[0] = -1;
+    for(int exponent=0; exponent<nn; exponent++){
+        table.alpha_to[exponent] = primitive_poly[prim_num][exponent];
+        table.alpha_to[exponent+nn] = primitive_poly[prim_num][exponent];
+        table.index_of[primitive_poly[prim_num][exponent]] = exponent;
     }
-    else if(recc_type==QPC){
-        int Fault_Chip_position = rand() % CHIP_NUM;
-        int Fault_bit_position = rand() % OECC_CW_LEN;
+    return table;
+}
 
-        Chip_array[Fault_Chip_position][Fault_bit_position]=1;
-        return;
+static_assert(is_primitive(0), "primitive polynomial file : the first polynomial is not primitive");
+constexpr GF_table gf_table=generate_gf_table(0); // RECC decoders use primitive_poly[0] (D^8+D^4+D^3+D^2+1)
+constexpr const int (&gf_alpha_to)[2*nn]=gf_table.alpha_to;
+constexpr const int (&gf_index_of)[nn+1]=gf_table.index_of;
+
+
+constexpr int index_of(unsigned int value){
+    return gf_index_of[value];
+}
+
+
+constexpr unsigned int gf_mul(unsigned int a, unsigned int b){
+    if (a == 0 || b == 0)
+        return 0;
+    return gf_alpha_to[gf_index_of[a] + gf_index_of[b]];
+}
+
+
+// b != 0
+constexpr unsigned int gf_div(unsigned int a, unsigned int b){
+    if (a == 0)
+        return 0;
+    return gf_alpha_to[gf_index_of[a] + nn - gf_index_of[b]];
+}
+
+
+// a != 0
+constexpr unsigned int gf_inv(unsigned int a){
+    return gf_alpha_to[nn - gf_index_of[a]];
+}
+
+
+/*------------------------------------------------------------------
+                        Random number streams
+-------------------------------------------------------------------*/
+// xoshiro256** (Blackman & Vigna). Every trial gets its own stream (see seed()),
+// so a given seed reproduces the same CE/DUE/SDC counts at any thread count.
+inline uint64_t splitmix64(uint64_t &x)
+{
+    uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+
+struct Xoshiro256ss {
+    uint64_t s[4];
+
+    // stream 'stream' is seeded with outputs 4*stream ~ 4*stream+3 of the splitmix64 sequence started at 'seed_'
+    void seed(uint64_t seed_, uint64_t stream){
+        uint64_t x = seed_ + stream*4*0x9E3779B97F4A7C15ULL;
+        for(int i=0; i<4; i++)
+            s[i] = splitmix64(x);
     }
-    else if(recc_type==AMDCHIPKILL){
-        int Fault_bit_position = rand() % OECC_CW_LEN;
 
-        Chip_array[Fault_Chip_position_][Fault_bit_position]=1;
-        return; 
+    inline uint64_t next(){
+        uint64_t result = rotl(s[1]*5, 7)*9;
+        uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+        return result;
     }
-    
+
+    static inline uint64_t rotl(uint64_t x, int k){
+        return (x << k) | (x >> (64-k));
+    }
+};
+
+typedef Xoshiro256ss Sim_rng; // any type with seed(seed, stream) and next() (64 random bits)
+
+thread_local Sim_rng sim_rng; // per-worker random state
+
+
+// 64 independent random bits
+inline uint64_t sim_rand64(){
+    return sim_rng.next();
 }
 
 
-// DE injection (Double Error injection)
-void error_injection_DBE(unsigned int Chip_array[][OECC_CW_LEN], int recc_type)
+// unbiased random number in [0, range) (Lemire's multiply-shift with rejection)
+inline unsigned int sim_rand_bounded(unsigned int range){
+    uint64_t m = (sim_rand64() >> 32) * range;
+    uint32_t l = (uint32_t)m;
+    if(l < range){
+        uint32_t threshold = (0U - range) % range;
+        while(l < threshold){
+            m = (sim_rand64() >> 32) * range;
+            l = (uint32_t)m;
+        }
+    }
+    return (unsigned int)(m >> 32);
+}
+
+
+/*------------------------------------------------------------------
+                        Importance sampling
+-------------------------------------------------------------------*/
+// Bit errors after the first one (anchor) of a trial are drawn from the mixture
+//   q(x) = (1-is_bias) * uniform(domain) + is_bias * uniform(anchor cluster),
+// where the anchor cluster is where the decoder accepts a multi-symbol correction
+// (AMDCHIPKILL : same codeword (BL pair), QPC : same chip and codeword, OOC : same chip pair).
+// The trial weight is the product of p(x)/q(x) over the draws (defensive mixture : weight <= 1/(1-is_bias) per draw).
+double is_bias=0; // 0 : plain Monte Carlo (--is-bias)
+
+struct Importance_sampling_state {
+    int anchor_chip, anchor_pos; // first bit error of the trial (-1 : none)
+    double weight; // likelihood ratio of the trial
+};
+
+thread_local Importance_sampling_state sim_is;
+
+
+// positions of chip 'chip' in the cluster of the anchor
+uint64_t cluster_mask(int recc_type, int chip)
 {
-    if (recc_type==OOC){
-        int count = 0;
-        while (count<2){
-            int Fault_Chip_position = rand() % OOC_CHIP_NUM;
-            int Fault_bit_position = rand() % OOC_OECC_CW_LEN;
+    if(recc_type==AMDCHIPKILL)
+        return SYMBOL_MASK(sim_is.anchor_pos/8);
+    else if(recc_type==QPC)
+        return (chip==sim_is.anchor_chip) ? QPC_codec::block_mask(sim_is.anchor_pos/QPC_codec::block_bits) : 0;
+    else if(recc_type==OOC)
+        return (chip%CHIP_NUM==sim_is.anchor_chip%CHIP_NUM) ? OOC_CHIP_MASK : 0;
+    return 0;
+}
 
-            if (Chip_array[Fault_Chip_position][Fault_bit_position] != 1){
-                Chip_array[Fault_Chip_position][Fault_bit_position] = 1;
-                count++;
-            }
+
+// k-th (0~) set bit position of a packed word
+int select_bit(uint64_t word, int k)
+{
+    for(int pos=0; pos<OECC_CW_LEN; pos++){
+        if(word & BIT_MASK(pos)){
+            if(k==0)
+                return pos;
+            k--;
         }
-        return;
     }
-    else if(recc_type==QPC){
-        int count = 0;
-        while (count<2){
-            int Fault_Chip_position = rand() % CHIP_NUM;
-            int Fault_bit_position = rand() % OECC_CW_LEN;
+    return -1;
+}
+
 
-            if (Chip_array[Fault_Chip_position][Fault_bit_position] != 1){
-                Chip_array[Fault_Chip_position][Fault_bit_position] = 1;
-                count++;
+// draw one bit error uniformly over the domain (fixed_chip (-1 : any of chip_num chips) x bit_num positions),
+// redrawing positions that are already erroneous if reject_set, and set it
+void draw_bit_error(uint64_t *Chip_array, uint32_t *dirty, int recc_type, int fixed_chip, bool reject_set)
+{
+    int chip_num = (recc_type==OOC) ? OOC_CHIP_NUM : CHIP_NUM;
+    int bit_num = (recc_type==OOC) ? OOC_OECC_CW_LEN : OECC_CW_LEN;
+    uint64_t domain_mask = (recc_type==OOC) ? OOC_CHIP_MASK : ~0ULL;
+    int first_chip = (fixed_chip<0) ? 0 : fixed_chip;
+    int last_chip = (fixed_chip<0) ? chip_num-1 : fixed_chip;
+    int Fault_Chip_position, Fault_bit_position;
+
+    // cluster size |C|, erroneous positions |O| and |O & C| in the domain
+    int cluster_num=0, set_num=0, set_cluster_num=0;
+    if(is_bias>0 && sim_is.anchor_chip>=0){
+        for(int chip=first_chip; chip<=last_chip; chip++){
+            uint64_t cluster = cluster_mask(recc_type, chip) & domain_mask;
+            cluster_num += __builtin_popcountll(cluster);
+            if(reject_set){
+                set_num += __builtin_popcountll(Chip_array[chip] & domain_mask);
+                set_cluster_num += __builtin_popcountll(Chip_array[chip] & cluster);
             }
         }
-        return;
     }
-    else if(recc_type==AMDCHIPKILL){
-        int count = 0;
-        while (count<2){
-            int Fault_Chip_position = rand() % CHIP_NUM;
-            int Fault_bit_position = rand() % OECC_CW_LEN;
-
-            if (Chip_array[Fault_Chip_position][Fault_bit_position] != 1){
-                Chip_array[Fault_Chip_position][Fault_bit_position] = 1;
-                count++;
+
+    do{
+        if(cluster_num>0 && (double)(sim_rand64()>>11)*0x1.0p-53 < is_bias){
+            int k = sim_rand_bounded(cluster_num);
+            for(Fault_Chip_position=first_chip; Fault_Chip_position<=last_chip; Fault_Chip_position++){
+                uint64_t cluster = cluster_mask(recc_type, Fault_Chip_position) & domain_mask;
+                if(k < __builtin_popcountll(cluster))
+                    break;
+                k -= __builtin_popcountll(cluster);
             }
+            Fault_bit_position = select_bit(cluster_mask(recc_type, Fault_Chip_position) & domain_mask, k);
         }
-        return;
+        else{
+            Fault_Chip_position = (fixed_chip<0) ? (int)sim_rand_bounded(chip_num) : fixed_chip;
+            Fault_bit_position = sim_rand_bounded(bit_num);
+        }
+    }while(reject_set && (Chip_array[Fault_Chip_position] & BIT_MASK(Fault_bit_position)));
+
+    if(cluster_num>0){ // p(x)/q(x) (both conditioned on x not erroneous yet)
+        double domain_num = (double)(last_chip-first_chip+1)*bit_num;
+        bool in_cluster = (cluster_mask(recc_type, Fault_Chip_position) & BIT_MASK(Fault_bit_position)) != 0;
+        double p = 1.0/(domain_num-set_num);
+        double q = (1-is_bias)/domain_num + (in_cluster ? is_bias/cluster_num : 0.0);
+        q /= 1.0 - ((1-is_bias)*set_num/domain_num + is_bias*set_cluster_num/cluster_num);
+        sim_is.weight *= p/q;
     }
+    if(sim_is.anchor_chip<0){
+        sim_is.anchor_chip = Fault_Chip_position;
+        sim_is.anchor_pos = Fault_bit_position;
+    }
+
+    Chip_array[Fault_Chip_position] |= BIT_MASK(Fault_bit_position);
+    *dirty |= 1u << Fault_Chip_position;
+    return;
 }
 
 
-// TBE injection (Triple Error injection)
-void error_injection_TBE(unsigned int Chip_array[][OECC_CW_LEN], int recc_type)
+// SE injection (Single Error injection)
+void error_injection_SE(int Fault_Chip_position_, uint64_t *Chip_array, uint32_t *dirty, int recc_type)
 {
-    if (recc_type==OOC){
-        int count = 0;
-        while (count<3){
-            int Fault_Chip_position = rand() % OOC_CHIP_NUM;
-            int Fault_bit_position = rand() % OOC_OECC_CW_LEN;
 
-            if (Chip_array[Fault_Chip_position][Fault_bit_position] != 1){
-                Chip_array[Fault_Chip_position][Fault_bit_position] = 1;
-                count++;
-            }
-        }
+    if (recc_type==OOC || recc_type==QPC){
+        draw_bit_error(Chip_array, dirty, recc_type, -1, false);
         return;
     }
-    else if(recc_type==QPC){
-        int count = 0;
-        while (count<3){
-            int Fault_Chip_position = rand() % CHIP_NUM;
-            int Fault_bit_position = rand() % OECC_CW_LEN;
+    else if(recc_type==AMDCHIPKILL){
+        draw_bit_error(Chip_array, dirty, recc_type, Fault_Chip_position_, false);
+        return; 
+    }
+    
+}
 
-            if (Chip_array[Fault_Chip_position][Fault_bit_position] != 1){
-                Chip_array[Fault_Chip_position][Fault_bit_position] = 1;
-                count++;
-            }
-        }
-        return;
+
+// DE injection (Double Error injection)
+void error_injection_DBE(uint64_t *Chip_array, uint32_t *dirty, int recc_type)
+{
+    if (recc_type==OOC || recc_type==QPC || recc_type==AMDCHIPKILL){
+        for(int count=0; count<2; count++)
+            draw_bit_error(Chip_array, dirty, recc_type, -1, true);
     }
-    else if(recc_type==AMDCHIPKILL){
-        int count = 0;
-        while (count<3){
-            int Fault_Chip_position = rand() % CHIP_NUM;
-            int Fault_bit_position = rand() % OECC_CW_LEN;
-
-            if (Chip_array[Fault_Chip_position][Fault_bit_position] != 1){
-                Chip_array[Fault_Chip_position][Fault_bit_position] = 1;
-                count++;
-            }
-        }
-        return;
+    return;
+}
+
+
+// TBE injection (Triple Error injection)
+void error_injection_TBE(uint64_t *Chip_array, uint32_t *dirty, int recc_type)
+{
+    if (recc_type==OOC || recc_type==QPC || recc_type==AMDCHIPKILL){
+        for(int count=0; count<3; count++)
+            draw_bit_error(Chip_array, dirty, recc_type, -1, true);
     }
+    return;
 }
 
 
 // Chipkill injection
-void error_injection_CHIPKILL(int Fault_Chip_position, unsigned int Chip_array[][OECC_CW_LEN], int recc_type)
+void error_injection_CHIPKILL(int Fault_Chip_position, uint64_t *Chip_array, uint32_t *dirty, int recc_type)
 {
-    // 50% error.
-    for(int Fault_pos=0; Fault_pos<OECC_CW_LEN; Fault_pos++){ // 0~63
-        if(rand()%2!=0) // 0(no error) 'or' 1(error)
-            Chip_array[Fault_Chip_position][Fault_pos]^=1;
-    }
+    // 50% error : each of the 64 bits (32 for OOC) is 0(no error) 'or' 1(error)
+    uint64_t chip_mask = (recc_type==OOC) ? OOC_CHIP_MASK : ~0ULL;
+    Chip_array[Fault_Chip_position] ^= sim_rand64() & chip_mask;
+    *dirty |= 1u << Fault_Chip_position;
     
     return;
+}
 
-    if (recc_type==OOC){
-        for(int Fault_pos=0; Fault_pos<OOC_OECC_CW_LEN; Fault_pos++){ // 0~63
-            if(rand()%2!=0) // 0(no error) 'or' 1(error)
-                Chip_array[Fault_Chip_position][Fault_pos]^=1;
-        }
-        for(int Fault_pos=0; Fault_pos<OOC_OECC_CW_LEN; Fault_pos++){ // 0~63
-            if(rand()%2!=0) // 0(no error) 'or' 1(error)
-                Chip_array[Fault_Chip_position+10][Fault_pos]^=1;
-        }
-        return;
-    }
-    else if(recc_type==QPC){
-        for(int Fault_pos=0; Fault_pos<OECC_CW_LEN; Fault_pos++){ // 0~63
-            if(rand()%2!=0) // 0(no error) 'or' 1(error)
-                Chip_array[Fault_Chip_position][Fault_pos]^=1;
-        }
-        return;
-    }
-    else if(recc_type==AMDCHIPKILL){
-        for(int Fault_pos=0; Fault_pos<OECC_CW_LEN; Fault_pos++){ // 0~63
-            if(rand()%2!=0) // 0(no error) 'or' 1(error)
-                Chip_array[Fault_Chip_position][Fault_pos]^=1;
-        }
-        return;
-    }    
+
+// bits of error_bits used by a pin error on line 'line' (0~3) of a chip (see set_pin_error)
+uint64_t pin_error_mask(int Fault_Chip_line, int recc_type)
+{
+    if(recc_type==AMDCHIPKILL) // positions 4*beat+line (beat : 0~15)
+        return 0x8888888888888888ULL >> Fault_Chip_line;
+    return SYMBOL_MASK(Fault_Chip_line) | SYMBOL_MASK(Fault_Chip_line+4);
 }
 
 
-// Pin_error injection
-void error_injection_pin(int Fault_Pin_position, unsigned int Chip_array[][OECC_CW_LEN], int recc_type)
+// pin Fault_Pin_position (0~39) with the erroneous bits 'error_bits'
+void set_pin_error(int Fault_Pin_position, uint64_t error_bits, uint64_t *Chip_array, uint32_t *dirty, int recc_type)
 {
     int Fault_Chip_position = Fault_Pin_position/4;
     int Fault_Chip_line = Fault_Pin_position % 4;
 
-    if (recc_type==OOC){
-        for(int Fault_pos=0; Fault_pos<8; Fault_pos++){ 
-            if(rand()%2!=0) // 0(no error) 'or' 1(error)
-                Chip_array[Fault_Chip_position][8*Fault_Chip_line+Fault_pos]=1;
-            if(rand()%2!=0) // 0(no error) 'or' 1(error)
-                Chip_array[Fault_Chip_position+10][8*Fault_Chip_line+Fault_pos]=1;
-        }
-        return;
-    }
-    else if(recc_type==QPC){
-        for(int Fault_pos=0; Fault_pos<8; Fault_pos++){
-            if(rand()%2!=0) // 0(no error) 'or' 1(error)
-                Chip_array[Fault_Chip_position][8*Fault_Chip_line+Fault_pos]=1;
-            if(rand()%2!=0) // 0(no error) 'or' 1(error)
-                Chip_array[Fault_Chip_position][32+8*Fault_Chip_line+Fault_pos]=1;
-        }
+    if (recc_type==OOC){ // positions 8*line ~ 8*line+7 of chip and chip+10
+        Chip_array[Fault_Chip_position] |= error_bits & SYMBOL_MASK(Fault_Chip_line);
+        Chip_array[Fault_Chip_position+10] |= (error_bits << 32) & SYMBOL_MASK(Fault_Chip_line);
+        *dirty |= (1u << Fault_Chip_position) | (1u << (Fault_Chip_position+10));
         return;
     }
-    else if(recc_type==AMDCHIPKILL){
-        for(int Fault_pos=0; Fault_pos<16; Fault_pos++){ 
-            if(rand()%2!=0) // 0(no error) 'or' 1(error)
-                Chip_array[Fault_Chip_position][4*Fault_pos+Fault_Chip_line]=1;
-        }
+    else if(recc_type==QPC || recc_type==AMDCHIPKILL){ // QPC : positions 8*line ~ 8*line+7 and 32+8*line ~ 32+8*line+7
+        Chip_array[Fault_Chip_position] |= error_bits & pin_error_mask(Fault_Chip_line, recc_type);
+        *dirty |= 1u << Fault_Chip_position;
     }
 
     return;
 }
 
 
+// Pin_error injection
+void error_injection_pin(int Fault_Pin_position, uint64_t *Chip_array, uint32_t *dirty, int recc_type)
+{
+    // each bit on the pin : 0(no error) 'or' 1(error)
+    set_pin_error(Fault_Pin_position, sim_rand64(), Chip_array, dirty, recc_type);
+    return;
+}
+
+
+// bit position index (0~639) of the draw_bit_error domain -> Chip_array
+void set_bit_error(int index, uint64_t *Chip_array, uint32_t *dirty, int recc_type)
+{
+    int bit_num = (recc_type==OOC) ? OOC_OECC_CW_LEN : OECC_CW_LEN;
+    Chip_array[index/bit_num] |= BIT_MASK(index%bit_num);
+    *dirty |= 1u << (index/bit_num);
+    return;
+}
+
+
 // RANK_error injection
-void error_injection_rank(unsigned int Chip_array[][OECC_CW_LEN], int recc_type)
+void error_injection_rank(uint64_t *Chip_array, uint32_t *dirty, int recc_type)
 {
-    if (recc_type==OOC){
-        for(int Fault_Chip_position=0; Fault_Chip_position<OOC_CHIP_NUM; Fault_Chip_position++){    
-            for(int Fault_pos=0; Fault_pos<OOC_OECC_CW_LEN; Fault_pos++){ 
-                if(rand()%2!=0) // 0(no error) 'or' 1(error)
-                    Chip_array[Fault_Chip_position][Fault_pos]=1;
-            }
-        }
-        return;
-    }
-    else if(recc_type==QPC){
-        for(int Fault_Chip_position=0; Fault_Chip_position<CHIP_NUM; Fault_Chip_position++){    
-            for(int Fault_pos=0; Fault_pos<OECC_CW_LEN; Fault_pos++){ 
-                if(rand()%2!=0) // 0(no error) 'or' 1(error)
-                    Chip_array[Fault_Chip_position][Fault_pos]=1;
-            }
-        }
-        return;
-    }
-    else if(recc_type==AMDCHIPKILL){
-        for(int Fault_Chip_position=0; Fault_Chip_position<CHIP_NUM; Fault_Chip_position++){    
-            for(int Fault_pos=0; Fault_pos<OECC_CW_LEN; Fault_pos++){ 
-                if(rand()%2!=0) // 0(no error) 'or' 1(error)
-                    Chip_array[Fault_Chip_position][Fault_pos]=1;
-            }
-        }
-        return;
+    int chip_num = (recc_type==OOC) ? OOC_CHIP_NUM : CHIP_NUM;
+    uint64_t chip_mask = (recc_type==OOC) ? OOC_CHIP_MASK : ~0ULL;
+
+    if (recc_type==OOC || recc_type==QPC || recc_type==AMDCHIPKILL){
+        for(int Fault_Chip_position=0; Fault_Chip_position<chip_num; Fault_Chip_position++) // 0(no error) 'or' 1(error)
+            Chip_array[Fault_Chip_position] |= sim_rand64() & chip_mask;
+        *dirty |= (1u << chip_num) - 1;
     }
+    return;
 }
 
 
-// OECC 1bit correction
-void error_correction_oecc(unsigned int *codeword)
+// OECC : the chip word (bit positions 0~63, 0~31 for OOC) is data column 'pos' of H_Matrix_OECC,
+// the other data bits and the check bits of the on-die codeword are error-free (not modeled).
+struct OECC_table {
+    uint64_t h_row[OECC_REDUN_LEN]; // row r of H over the chip word (packed, see BIT_MASK)
+    signed char syndrome_pos[1<<OECC_REDUN_LEN]; // syndrome -> H column (-1 : no column, not corrected)
+};
+
+
+constexpr OECC_table generate_oecc_table()
 {
-    unsigned int Syndromes[OECC_REDUN_LEN]; // 8 x 1
-    
-    // Syndromes = H * C^T
-    for(int row=0; row<OECC_REDUN_LEN; row++){
-        unsigned int row_value=0;
-        for(int column=0; column<OECC_CW_LEN; column++)
-            row_value=row_value^(H_Matrix_OECC[row][column] * codeword[column]);
-        Syndromes[row]=row_value;
-    }
-
-    // error correction (Check Syndromes)
-    int cnt=0;
-    for(int error_pos=0; error_pos<OECC_CW_LEN; error_pos++){
-        cnt=0;
-        for(int row=0; row<OECC_REDUN_LEN; row++){
-            if(Syndromes[row]==H_Matrix_OECC[row][error_pos])
-                cnt++;
-            else
-                break;
-        }
-        // 1-bit error -> error correction 
-        if(cnt==OECC_REDUN_LEN){
-            codeword[error_pos]^=1;
-            return;
-        }
+    OECC_table table{};
+    for(int row=0; row<OECC_REDUN_LEN; row++)
+        for(int pos=0; pos<OECC_CW_LEN; pos++)
+            if(H_Matrix_OECC[row][pos])
+                table.h_row[row] |= BIT_MASK(pos);
+
+    // syndrome 0 : no error, first matching column otherwise (as the column-by-column search)
+    for(int syndrome=0; syndrome<(1<<OECC_REDUN_LEN); syndrome++)
+        table.syndrome_pos[syndrome]=-1;
+    for(int column=OECC_H_CW_LEN-1; column>=0; column--){
+        unsigned int syndrome=0;
+        for(int row=0; row<OECC_REDUN_LEN; row++)
+            syndrome |= (H_Matrix_OECC[row][column] & 1) << row;
+        if(syndrome!=0)
+            table.syndrome_pos[syndrome] = (column<OECC_CW_LEN) ? column : -1; // -1 : flips an unmodeled bit
     }
+    return table;
+}
 
+constexpr OECC_table oecc_table=generate_oecc_table();
+constexpr const uint64_t (&oecc_h_row)[OECC_REDUN_LEN]=oecc_table.h_row;
+constexpr const signed char (&oecc_syndrome_pos)[1<<OECC_REDUN_LEN]=oecc_table.syndrome_pos;
+
+
+// OECC 1bit correction of a chip word (positions 0 ~ bit_num-1), syndrome bit r = parity of (H row r & word)
+// (the bits beyond bit_num are not part of the codeword : OOC chips only use positions 0~31)
+void error_correction_oecc(uint64_t *chip_word, int bit_num)
+{
+    uint64_t codeword = *chip_word & ((bit_num<OECC_CW_LEN) ? ~(~0ULL >> bit_num) : ~0ULL);
+    unsigned int syndrome=0;
+    for(int row=0; row<OECC_REDUN_LEN; row++)
+        syndrome |= (unsigned int)(__builtin_popcountll(oecc_h_row[row] & codeword) & 1) << row;
+
+    // 1-bit error (or a miscorrection) -> error correction
+    int error_pos=oecc_syndrome_pos[syndrome];
+    if(error_pos>=0 && error_pos<bit_num)
+        *chip_word ^= BIT_MASK(error_pos);
     return;
 }
 
 
 /*------------------------------------------------------------------
-                        OOC Correction
+                        Instrumentation
 -------------------------------------------------------------------*/
-int error_correction_OOC(unsigned int *codeword_OOC)
+// --stats : throughput, progress with ETA, per-stage cycles and decoder path histograms (stderr).
+// Off by default : the hot path then only tests sim_stats_on. The stage cycles are sampled
+// (1 in STATS_SAMPLE trials is timed with the TSC), the decoder paths are counted for every trial.
+enum STATS_STAGE {STAGE_INJECT=0, STAGE_OECC=1, STAGE_GATHER=2, STAGE_DECODE=3, STAGE_SDC=4, STAGE_NUM=5};
+enum STATS_PATH {PATH_ZERO=0, PATH_CE=1, PATH_DUE=2, PATH_NUM=3}; // per decoded codeword : zero syndrome, CE, DUE
+
+int sim_stats_on=0; // --stats
+
+struct Sim_stats {
+    long long trial_num, sampled_num;
+    uint64_t cycles[STAGE_NUM]; // of the sampled trials
+    long long path[PATH_NUM];
+    long long corrected[RS_tt_MAX+1]; // QPC/OOC CE by number of corrected symbols
+    uint64_t stamp; // cycle counter at the end of the last stage (sampled trial)
+    bool sample; // the running trial is timed
+};
+
+thread_local Sim_stats sim_stats; // per worker, added to stats_total by stats_flush
+Sim_stats stats_total;
+mutex stats_lock;
+
+inline uint64_t sim_cycles()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return (uint64_t)chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+// start of trial 'trial' (only called with --stats)
+inline void stats_trial_begin(long long trial)
+{
+    sim_stats.trial_num++;
+    sim_stats.sample = (trial & (STATS_SAMPLE-1))==0;
+    if(sim_stats.sample){
+        sim_stats.sampled_num++;
+        sim_stats.stamp=sim_cycles();
+    }
+}
+
+// end of 'stage' of the running trial
+inline void stats_stage(int stage)
+{
+    if(sim_stats_on && sim_stats.sample){
+        uint64_t now=sim_cycles();
+        sim_stats.cycles[stage] += now-sim_stats.stamp;
+        sim_stats.stamp=now;
+    }
+}
+
+inline void stats_path(int path)
 {
-   int i,j,u,q ;
+    if(sim_stats_on)
+        sim_stats.path[path]++;
+}
 
-   int elp[nn-OOC_kk+2][nn-OOC_kk], d[nn-OOC_kk+2], l[nn-OOC_kk+2], u_lu[nn-OOC_kk+2], s[nn-OOC_kk+1] ; 
-   int count=0, syn_error=0, root[OOC_tt], loc[OOC_tt], z[OOC_tt+1], err[nn], reg[OOC_tt+1]; 
-   unsigned int recd[OOC_nn_short] = {0};
+// the counters of the calling worker -> stats_total
+void stats_flush()
+{
+    if(!sim_stats_on)
+        return;
+    lock_guard<mutex> guard(stats_lock);
+    stats_total.trial_num += sim_stats.trial_num;
+    stats_total.sampled_num += sim_stats.sampled_num;
+    for(int stage=0; stage<STAGE_NUM; stage++)
+        stats_total.cycles[stage] += sim_stats.cycles[stage];
+    for(int path=0; path<PATH_NUM; path++)
+        stats_total.path[path] += sim_stats.path[path];
+    for(int L=0; L<=RS_tt_MAX; L++)
+        stats_total.corrected[L] += sim_stats.corrected[L];
+    memset(&sim_stats, 0, sizeof(sim_stats));
+    return;
+}
 
-  for (i=1; i<=2*OOC_tt; i++){
-    s[i] = 0;
+// 'done' of 'total' trials (or other units) after 'seconds'
+void stats_progress(const char *unit, long long done, long long total, double seconds)
+{
+    if(!sim_stats_on)
+        return;
+    double rate = (seconds>0) ? done/seconds : 0;
+    fprintf(stderr,"[progress] %lld/%lld %s (%.1f%%) : %.3e %s/s, ETA %.1f s\n",done,total,unit,100.0*done/total,rate,unit,(rate>0) ? (total-done)/rate : 0.0);
+    return;
+}
 
-    for(int symbol_index=0; symbol_index<OOC_CW_SYMBOL_NUM; symbol_index++){ 
-        unsigned exponent=255; 
-        unsigned symbol_value=0; 
+// 'num' trials (or other units) in 'seconds', then the counters of all workers
+void stats_report(const char *unit, long long num, double seconds)
+{
+    if(!sim_stats_on)
+        return;
+    const char *stage_name[STAGE_NUM]={"inject", "oecc", "gather", "decode", "sdc check"};
+    const char *path_name[PATH_NUM]={"zero syndrome", "CE", "DUE"};
+    fprintf(stderr,"[stats] %lld %s in %.3f s : %.3e %s/s\n",num,unit,seconds,(seconds>0) ? num/seconds : 0.0,unit);
+
+    uint64_t cycle_sum=0;
+    for(int stage=0; stage<STAGE_NUM; stage++)
+        cycle_sum += stats_total.cycles[stage];
+    if(stats_total.sampled_num>0 && cycle_sum>0){
+        fprintf(stderr,"[stats] cycles per trial (%lld of %lld trials timed) :",stats_total.sampled_num,stats_total.trial_num);
+        for(int stage=0; stage<STAGE_NUM; stage++)
+            fprintf(stderr,"%s %s %.1f (%.1f%%)",(stage>0) ? "," : "",stage_name[stage],(double)stats_total.cycles[stage]/stats_total.sampled_num,100.0*stats_total.cycles[stage]/cycle_sum);
+        fprintf(stderr,"\n");
+    }
 
-        for(int symbol_value_index=0; symbol_value_index<SYMBOL_SIZE; symbol_value_index++){ 
-            symbol_value^=(codeword_OOC[symbol_index*8+symbol_value_index] << (SYMBOL_SIZE-1-symbol_value_index)); 
+    long long path_sum=0;
+    for(int path=0; path<PATH_NUM; path++)
+        path_sum += stats_total.path[path];
+    if(path_sum>0){
+        fprintf(stderr,"[stats] decoder paths (%lld codewords) :",path_sum);
+        for(int path=0; path<PATH_NUM; path++)
+            fprintf(stderr,"%s %s %lld (%.2f%%)",(path>0) ? "," : "",path_name[path],stats_total.path[path],100.0*stats_total.path[path]/path_sum);
+        fprintf(stderr,"\n");
+    }
+    long long corrected_sum=0;
+    for(int L=1; L<=RS_tt_MAX; L++)
+        corrected_sum += stats_total.corrected[L];
+    if(corrected_sum>0){
+        fprintf(stderr,"[stats] QPC/OOC CE by corrected symbols :");
+        for(int L=1, first=1; L<=RS_tt_MAX; L++){
+            if(stats_total.corrected[L]>0){
+                fprintf(stderr,"%s %d symbol(s) %lld",first ? "" : ",",L,stats_total.corrected[L]);
+                first=0;
+            }
         }
+        fprintf(stderr,"\n");
+    }
+    return;
+}
 
-        recd[symbol_index] = symbol_value;
 
-        for(int prim_exponent=0; prim_exponent<255; prim_exponent++){
-            if(symbol_value==primitive_poly[0][prim_exponent]){
-                exponent=prim_exponent;
-                break;
+/*------------------------------------------------------------------
+                    Shortened RS decoding
+-------------------------------------------------------------------*/
+// RS over GF(2^8) with roots a^1 ~ a^2t, shortened to n_short symbols (symbol j <-> a^j).
+// A code is a type (RS_codec, see the packed chip layout) and the decoder is instantiated per code, so t, n_short and
+// the scratch arrays are compile-time constants :
+//   syndromes lane-parallel over the nonzero symbols only, Berlekamp-Massey with 2t-sized
+//   scratch (DUE as soon as the locator degree exceeds t), Chien search over the n_short valid positions only.
+
+// syndrome contribution of symbol j (0~79) to s1~s16, in 8-bit lanes (lane (i-1)%8 of word (i-1)/8 : s_i),
+// split by nibble : v*a^(ij) = v_low*a^(ij) ^ v_high*a^(ij), so a symbol costs two loads and XORs per 8 syndromes
+struct RS_table {
+    uint64_t syndrome_lane[RS_nn_short_MAX][2][16][2]; // [symbol j][low/high nibble][nibble value][s1~s8, s9~s16]
+};
+
+constexpr RS_table generate_rs_syndrome_table()
+{
+    RS_table table{};
+    for(int symbol_index=0; symbol_index<RS_nn_short_MAX; symbol_index++){
+        for(int half=0; half<2; half++){
+            for(int nibble=0; nibble<16; nibble++){
+                unsigned int symbol_value = nibble << (4*half);
+                for(int word=0; word<2; word++){
+                    uint64_t lanes=0;
+                    for(int lane=0; lane<8 && symbol_value!=0; lane++){
+                        int i=8*word+lane+1;
+                        lanes |= (uint64_t)gf_alpha_to[(index_of(symbol_value)+i*symbol_index)%nn] << (SYMBOL_SIZE*lane);
+                    }
+                    table.syndrome_lane[symbol_index][half][nibble][word]=lanes;
+                }
             }
         }
-        
-        if(exponent!=255)
-            s[i]^=primitive_poly[0][(exponent+i*symbol_index)%255];
     }
+    return table;
+}
 
-    if (s[i]!=0){
-        syn_error=1;
-    }    
-    s[i] = index_of(s[i]);
-  }
-
- // Syndrome != 0 -> CE 'or' DUE 'or' SDC
-  if (syn_error)       /* if errors, try and correct */
-  {
-/* initialise table entries */
-      d[0] = 0 ;           /* index form */
-      d[1] = s[1] ;        /* index form */
-      elp[0][0] = 0 ;      /* index form */
-      elp[1][0] = 1 ;      /* polynomial form */
-      for (i=1; i<nn-OOC_kk; i++)
-        { elp[0][i] = -1 ;   /* index form */
-          elp[1][i] = 0 ;   /* polynomial form */
+constexpr RS_table rs_table=generate_rs_syndrome_table();
+constexpr const uint64_t (&rs_syndrome_lane)[RS_nn_short_MAX][2][16][2]=rs_table.syndrome_lane;
+
+
+// syndromes s[1~2t] (polynomial form) of codeword 'block' of the dirty chips,
+// straight from the chip words (see gather_codeword for the symbol order) and over nonzero symbols only,
+// returns 0 when all of them are zero (NE : the codeword does not need to be gathered)
+template<class Codec>
+int rs_syndrome_packed(const uint64_t *Chip_array, uint32_t dirty, int block, int *s)
+{
+    uint64_t lanes[Codec::syndrome_word_num]={0,};
+    for(uint32_t mask=dirty; mask; mask&=mask-1){
+        int Chip_idx=__builtin_ctz(mask);
+        uint64_t word = (Chip_array[Chip_idx] << (Codec::block_bits*block)) & Codec::block_mask(0);
+        while(word){
+            int symbol = __builtin_clzll(word)/SYMBOL_SIZE; // 0 ~ chip_symbols-1
+            unsigned int symbol_value = get_symbol(word, symbol);
+            const uint64_t (*table)[16][2] = rs_syndrome_lane[Chip_idx*Codec::chip_symbols+symbol];
+            for(int w=0; w<Codec::syndrome_word_num; w++)
+                lanes[w] ^= table[0][symbol_value & 0xF][w] ^ table[1][symbol_value >> 4][w];
+            word &= ~SYMBOL_MASK(symbol);
         }
-      l[0] = 0 ;     
-      l[1] = 0 ;     
-      u_lu[0] = -1 ; /* index form */
-      u_lu[1] = 0 ;  /* index form */
-      u = 0 ; //step
-
-      do
-      {
-        u++ ;
-        if (d[u]==-1)  // s[i] == 0
-          { l[u+1] = l[u];
-            for (i=0; i<=l[u]; i++)
-             {  elp[u+1][i] = elp[u][i] ;
-                elp[u][i] = index_of(elp[u][i]) ;
-             }
-          }
-        else
-/* search for words with greatest u_lu[q] for which d[q]!=0 */
-          { q = u-1 ;
-            while ((d[q]==-1) && (q>0)) q-- ;
-/* have found first non-zero d[q]  */
-            if (q>0)
-             { j=q ;
-               do
-               { j-- ;
-                 if ((d[j]!=-1) && (u_lu[q]<u_lu[j]))
-                   q = j ;
-               }while (j>0) ;
-             }
-
-/* have now found q such that d[u]!=0 and u_lu[q] is maximum */
-/* store degree of new elp polynomial */
-            if (l[u]>l[q]+u-q)  l[u+1] = l[u] ;
-            else  l[u+1] = l[q]+u-q ;
-
-/* form new elp(x) */
-            for (i=0; i<nn-OOC_kk; i++)    elp[u+1][i] = 0 ;
-            for (i=0; i<=l[q]; i++)
-              if (elp[q][i]!=-1)
-                elp[u+1][i+u-q] = primitive_poly[0][(d[u]+nn-d[q]+elp[q][i])%nn] ;
-            for (i=0; i<=l[u]; i++)
-              { elp[u+1][i] ^= elp[u][i] ;
-                elp[u][i] = index_of(elp[u][i]) ;  /*convert old elp value to index*/
-              }
-          }
-        u_lu[u+1] = u-l[u+1] ;
-
-/* form (u+1)th discrepancy */
-        if (u<nn-OOC_kk)    /* no discrepancy computed on last iteration */
-          {
-            if (s[u+1]!=-1)
-                   d[u+1] = primitive_poly[0][s[u+1]] ;
-            else
-              d[u+1] = 0 ;
-            for (i=1; i<=l[u+1]; i++)
-              if ((s[u+1-i]!=-1) && (elp[u+1][i]!=0))
-                d[u+1] ^= primitive_poly[0][(s[u+1-i]+index_of(elp[u+1][i]))%nn] ;
-            d[u+1] = index_of(d[u+1]) ;    /* put d[u+1] into index form */
-          }
-      } while ((u<nn-OOC_kk) && (l[u+1]<=OOC_tt)) ;
-
-      u++ ;
-
-      ////////////////////////////////////////////////////
-      // error correction start!!!!!!!!!!!!!!!!!!!!!!!!!
-      ////////////////////////////////////////////////////
-
-      // CE 'or' SDC cases
-      if (l[u]<=OOC_tt)         /* can correct error */
-      {
-/* put elp into index form */
-         for (i=0; i<=l[u]; i++)   elp[u][i] = index_of(elp[u][i]) ;
-
-/* find roots of the error location polynomial -> finding error location */
-        for (i=1; i<=l[u]; i++)
-          reg[i] = elp[u][i];
-        
-        count = 0;
-        for (i=1; i<=nn; i++){  
-          q = 1 ;
-          for (j=1; j<=l[u]; j++)
-            if (reg[j]!=-1){ 
-              reg[j] = (reg[j]+j)%nn;
-              q ^= primitive_poly[0][reg[j]];
-            }
-          if (!q) {        /* store root and error location number indices */
-            root[count] = i;
-            loc[count] = nn-i; // -> error location
-            count++;
-          }
+    }
+    uint64_t nonzero=0;
+    for(int w=0; w<Codec::syndrome_word_num; w++)
+        nonzero |= lanes[w];
+    for(int i=1; i<=2*Codec::tt; i++)
+        s[i] = (int)(lanes[(i-1)/8] >> (SYMBOL_SIZE*((i-1)%8))) & 0xFF;
+    return nonzero != 0;
+}
+
+
+// error locator polynomial elp[0~L] (polynomial form, elp[0]=1), returns its degree L (> TT : DUE, stops early)
+template<int TT>
+int rs_berlekamp_massey(const int *s, int *elp)
+{
+    int prev[2*TT+1], temp[2*TT+1];
+    int L=0, shift=1, prev_d=1;
+    for(int i=0; i<=2*TT; i++)
+        elp[i]=prev[i]=0;
+    elp[0]=prev[0]=1;
+
+    for(int r=1; r<=2*TT; r++){
+        // discrepancy
+        int d=s[r];
+        for(int i=1; i<=L; i++)
+            d^=gf_mul(elp[i], s[r-i]);
+        if(d==0){
+            shift++;
+            continue;
         }
-        
-        int CE_cases=1;
-        //printf("error location check! (shortened RS code!)\n");
-        for(int index=0; index<count; index++){
-          if(loc[index]>=OOC_nn_short) // except for zero-padding part!!
-            CE_cases=0;
+        int coef=gf_div(d, prev_d);
+        if(2*L<r){ // length change
+            memcpy(temp, elp, sizeof(temp));
+            for(int i=0; i+shift<=2*TT; i++)
+                elp[i+shift]^=gf_mul(coef, prev[i]);
+            memcpy(prev, temp, sizeof(prev));
+            L=r-L;
+            prev_d=d;
+            shift=1;
+            if(L>TT) // the degree never decreases
+                return L;
         }
-        
-        if (l[u]>4){
-            int reference_value = loc[0] / 4;
-            for (int index = 0; index < count; index++) {
-                int divided_value = loc[index] / 4;             
-                
-                if ((divided_value != reference_value) && ((divided_value + 10) != reference_value)) {
-                    CE_cases = 0;
-                }
-            }
+        else{
+            for(int i=0; i+shift<=2*TT; i++)
+                elp[i+shift]^=gf_mul(coef, prev[i]);
+            shift++;
         }
+    }
+    return L;
+}
 
-         // CE 'or' SDC cases
-         if (count==l[u] && CE_cases==1){    /* no. roots = degree of elp hence <= tt errors*/
-          //printf("CE 'or' SDC cases\n");
-          //printf("count : %d\n",count);
-/* form polynomial z(x) */
-          for (i=1; i<=l[u]; i++){        /* Z[0] = 1 always - do not need */
-            if ((s[i]!=-1) && (elp[u][i]!=-1))
-              z[i] = primitive_poly[0][s[i]] ^ primitive_poly[0][elp[u][i]];
-            else if ((s[i]!=-1) && (elp[u][i]==-1))
-              z[i] = primitive_poly[0][s[i]] ;
-            else if ((s[i]==-1) && (elp[u][i]!=-1))
-              z[i] = primitive_poly[0][elp[u][i]] ;
-            else
-              z[i] = 0 ;
-            for (j=1; j<i; j++){
-              if ((s[j]!=-1) && (elp[u][i-j]!=-1))
-                z[i] ^= primitive_poly[0][(elp[u][i-j] + s[j])%nn];
-            }
-            z[i] = index_of(z[i]);         /* put into index form */
-          }
-
-  /* evaluate errors at locations given by error location numbers loc[i] */
-          for (i=0; i<nn; i++){ 
-            err[i] = 0;
-          }
-
-          for (i=0; i<l[u]; i++){    /* compute numerator of error term first */
-            err[loc[i]] = 1;       /* accounts for z[0] */
-            for (j=1; j<=l[u]; j++){
-              if (z[j]!=-1)
-                err[loc[i]] ^= primitive_poly[0][(z[j]+j*root[i])%nn];
-            }
-            if (err[loc[i]]!=0){
-              err[loc[i]] = index_of(err[loc[i]]);
-                q = 0;     /* form denominator of error term */
-                for (j=0; j<l[u]; j++){
-                  if (j!=i)
-                    q += index_of(1^primitive_poly[0][(loc[j]+root[i])%nn]);
-                }
-                q = q % nn;
-                err[loc[i]] = primitive_poly[0][(err[loc[i]]-q+nn)%nn];
-                recd[loc[i]] ^= err[loc[i]];  /*recd[i] must be in polynomial form */   
-            }
-          }
 
-            for (int symbol_index=0; symbol_index<80; symbol_index++) {
-                if (recd[symbol_index] == 0)
-                    for (int symbol_value_index=0; symbol_value_index<8; symbol_value_index++){
-                        codeword_OOC[symbol_index*8+symbol_value_index] = 0;
-                    }
+// roots of elp (degree L <= TT) among the N_SHORT valid positions -> loc[] (largest position first),
+// returns the number of roots found ; position j is a root when elp(a^-j) = 0 (a^-j = a^(nn-j))
+template<int TT, int N_SHORT>
+int rs_chien_search(const int *elp, int L, int *loc)
+{
+    int reg[TT+1], count=0;
+    for(int k=1; k<=L; k++) // exponent of elp[k] * a^(k*(nn-N_SHORT)), one step before position N_SHORT-1
+        reg[k] = (elp[k]!=0) ? (index_of(elp[k]) + k*(nn-N_SHORT)) % nn : -1;
+
+    for(int j=N_SHORT-1; j>=0 && count<L; j--){
+        int q=1;
+        for(int k=1; k<=L; k++){
+            if(reg[k]!=-1){
+                reg[k]+=k;
+                if(reg[k]>=nn)
+                    reg[k]-=nn;
+                q^=gf_alpha_to[reg[k]];
             }
-
-          return CE;
-          /*
-          printf("err (error values) : ");
-          for(int index=0; index<nn; index++)
-            printf("%d ",err[index]);
-          printf("\n");
-          */
         }
-        // DUE cases
-        else{    /* no. roots != degree of elp => >tt errors and cannot solve */
-          //printf("DUE cases!!!\n");
+        if(!q)
+            loc[count++]=j;
+    }
+    return count;
+}
 
-          return DUE;
+
+// error values at loc[0~L-1] (Forney, z(x) = 1 + z1 x + ... form) -> codeword
+// as in the full-length decoder, a symbol is only updated (cleared) when its corrected value is 0
+template<int TT>
+void rs_correct(unsigned int *codeword, const int *s, const int *elp, int L, const int *loc)
+{
+    int z[TT+1];
+    for(int i=1; i<=L; i++){
+        z[i]=s[i]^elp[i];
+        for(int j=1; j<i; j++)
+            z[i]^=gf_mul(s[j], elp[i-j]);
+    }
+
+    for(int i=0; i<L; i++){
+        int root=(nn-loc[i])%nn;
+        unsigned int err=1; // numerator (accounts for z[0])
+        for(int j=1; j<=L; j++){
+            if(z[j]!=0)
+                err^=gf_alpha_to[(index_of(z[j])+j*root)%nn];
         }
-      }
-    // DUE cases
-     else{         /* elp has degree has degree >tt hence cannot solve */
-       //printf("DUE cases!\n");
-       return DUE;
-     }
-  }
-  // NE 'or' SDC cases
-  else{       /* no non-zero syndromes => no errors: output received codeword */
-    //printf("NE 'or' SDC cases!\n");
-    return NE;
-  }
+        if(err!=0){
+            int q=0; // denominator
+            for(int j=0; j<L; j++){
+                if(j!=i)
+                    q+=index_of(1^gf_alpha_to[(loc[j]+root)%nn]);
+            }
+            err=gf_alpha_to[(index_of(err)-q%nn+nn)%nn];
+            if((codeword[loc[i]]^err)==0)
+                codeword[loc[i]]=0;
+        }
+    }
+    return;
 }
 
 
 /*------------------------------------------------------------------
-                        QPC Correction
+                    RS Correction (QPC, OOC)
 -------------------------------------------------------------------*/
-int error_correction_QPC(unsigned int *codeword)
+// codeword : n_short 8-bit symbols (see gather_codeword), corrected symbols are cleared in place
+// s : its syndromes s[1~2t] (rs_syndrome_packed), not all zero -> CE 'or' DUE 'or' SDC
+template<class Codec>
+int error_correction_RS(unsigned int *codeword, const int *s)
 {
-   int i,j,u,q;
-
-   int elp[nn-QPC_kk+2][nn-QPC_kk], d[nn-QPC_kk+2], l[nn-QPC_kk+2], u_lu[nn-QPC_kk+2], s[nn-QPC_kk+1] ; 
-   int count=0, syn_error=0, root[QPC_tt], loc[QPC_tt], z[QPC_tt+1], err[nn], reg[QPC_tt+1]; 
-   unsigned int recd[QPC_nn_short] = {0};
+    int elp[2*Codec::tt+1], loc[Codec::tt];
+
+    int L=rs_berlekamp_massey<Codec::tt>(s, elp);
+    if(L>Codec::tt) // elp has degree > tt hence cannot solve
+        return DUE;
+
+    // no. roots (at valid positions) != degree of elp => >tt errors and cannot solve
+    int count=rs_chien_search<Codec::tt, Codec::n_short>(elp, L, loc);
+    if(count!=L)
+        return DUE;
+
+    // more than spread_tt symbol errors are only corrected within one chip group
+    if(L>Codec::spread_tt){
+        int reference_group = (loc[0]/Codec::chip_symbols) % Codec::group_chips;
+        for(int index=1; index<count; index++){
+            if((loc[index]/Codec::chip_symbols) % Codec::group_chips != reference_group)
+                return DUE;
+        }
+    }
 
-  for (i=1; i<=2*QPC_tt; i++){
-    s[i] = 0;
+    rs_correct<Codec::tt>(codeword, s, elp, L, loc);
+    if(sim_stats_on)
+        sim_stats.corrected[L]++;
+    return CE;
+}
 
-    for(int symbol_index=0; symbol_index<QPC_CW_SYMBOL_NUM; symbol_index++){ // 0~39
-        unsigned exponent=255;
-        unsigned symbol_value=0; // 0000_0000 ~ 1111_1111
 
-        for(int symbol_value_index=0; symbol_value_index<SYMBOL_SIZE; symbol_value_index++){ // 8-bit symbol
-            symbol_value^=(codeword[symbol_index*8+symbol_value_index] << (SYMBOL_SIZE-1-symbol_value_index)); // <<7, <<6, ... <<0
+/*------------------------------------------------------------------
+                        AMD Correction
+-------------------------------------------------------------------*/
+// The decision only depends on the syndrome (S0, S1), so it is tabulated (at compile time) :
+//   NE  : S0 = S1 = 0
+//   CE  : S0, S1 != 0 and S1/S0 = a^i with i < 10 (single symbol error e = S0 at position i)
+//   DUE : otherwise (a single symbol error gives S0 = e, S1 = e*a^i, both nonzero)
+struct AMD_syndrome_entry {
+    unsigned char result; // NE, CE, DUE
+    unsigned char position; // CE : symbol (chip) position, the correction value is S0
+};
+
+struct AMD_table {
+    AMD_syndrome_entry syndrome[1<<(2*SYMBOL_SIZE)]; // index : (S0 << 8) | S1
+};
+
+constexpr AMD_table generate_amd_syndrome_table()
+{
+    AMD_table table{};
+    for(int S0=0; S0<=nn; S0++){
+        for(int S1=0; S1<=nn; S1++){
+            AMD_syndrome_entry &entry=table.syndrome[(S0<<SYMBOL_SIZE)|S1];
+            entry.position=0;
+            if(S0==0 && S1==0)
+                entry.result=NE;
+            else if(S0==0 || S1==0)
+                entry.result=DUE;
+            else{
+                int error_symbol_position_recc=index_of(gf_div(S1,S0)); // S1/S0 = a^i
+                entry.result = (error_symbol_position_recc<CHIP_NUM) ? CE : DUE;
+                entry.position = (error_symbol_position_recc<CHIP_NUM) ? error_symbol_position_recc : 0;
+            }
         }
+    }
+    return table;
+}
 
-        recd[symbol_index] = symbol_value;
+constexpr AMD_table amd_table=generate_amd_syndrome_table();
+constexpr const AMD_syndrome_entry (&amd_syndrome_table)[1<<(2*SYMBOL_SIZE)]=amd_table.syndrome;
 
-        for(int prim_exponent=0; prim_exponent<255; prim_exponent++){
-            if(symbol_value==primitive_poly[0][prim_exponent]){
-                exponent=prim_exponent;
-                break;
-            }
-        }
-        
-        if(exponent!=255) // s[i] = (a^exponent0) ^ (a^[exponent1+i*1]) ^ (a^[exponent2+i*2]) ... ^ (a^[exponent39+i*39])
-            s[i]^=primitive_poly[0][(exponent+i*symbol_index)%255];
-    }
-
-    if (s[i]!=0)  syn_error=1;    
-    s[i] = index_of(s[i]);
-  }
-
- // Syndrome != 0 -> CE 'or' DUE 'or' SDC
-  if (syn_error)       /* if errors, try and correct */
-  {
-/* initialise table entries */
-      d[0] = 0 ;           /* index form */
-      d[1] = s[1] ;        /* index form */
-      elp[0][0] = 0 ;      /* index form */
-      elp[1][0] = 1 ;      /* polynomial form */
-      for (i=1; i<nn-QPC_kk; i++)
-        { elp[0][i] = -1 ;   /* index form */
-          elp[1][i] = 0 ;   /* polynomial form */
-        }
-      l[0] = 0 ;     
-      l[1] = 0 ;     
-      u_lu[0] = -1 ; /* index form */
-      u_lu[1] = 0 ;  /* index form */
-      u = 0 ; //step
-
-      do
-      {
-        u++ ;
-        if (d[u]==-1)  // s[i] == 0
-          { l[u+1] = l[u];
-            for (i=0; i<=l[u]; i++)
-             {  elp[u+1][i] = elp[u][i] ;
-                elp[u][i] = index_of(elp[u][i]) ;
-             }
-          }
+
+// a*x in each 8-bit lane (polynomial basis : shift, reduce by a^8 when the top bit falls out)
+inline uint64_t gf_xtime_lanes(uint64_t x)
+{
+    uint64_t carry = (x >> 7) & 0x0101010101010101ULL;
+    return ((x & 0x7F7F7F7F7F7F7F7FULL) << 1) ^ (carry * gf_alpha_to[SYMBOL_SIZE]);
+}
+
+
+// syndromes of the 8 codewords (symbol k of every chip = BL 2k, 2k+1) at once, lane k of S0/S1 :
+// S0 = XOR of the chip words, S1 = sum of a^i * (chip i word) by Horner's rule
+void amd_syndrome_lanes(const uint64_t *Chip_array, uint32_t dirty, uint64_t *S0, uint64_t *S1)
+{
+    *S0=0;
+    *S1=0;
+    for(int Chip_idx=(dirty!=0) ? 31-__builtin_clz(dirty) : -1; Chip_idx>=0; Chip_idx--){ // from the last dirty chip
+        *S0 ^= Chip_array[Chip_idx];
+        *S1 = gf_xtime_lanes(*S1) ^ Chip_array[Chip_idx];
+    }
+    return;
+}
+
+
+// codeword : symbol 'symbol_index' (BL pair) of the 10 chips with syndrome (S0, S1), corrected in place
+int error_correction_AMDCHIPKILL(uint64_t *Chip_array, uint32_t *dirty, int symbol_index, unsigned int S0, unsigned int S1, set<int> &error_chip_position)
+{
+    const AMD_syndrome_entry &entry=amd_syndrome_table[(S0<<SYMBOL_SIZE)|S1];
+    if(entry.result==CE){ // error chip location : 0~9
+        Chip_array[entry.position] ^= (uint64_t)S0 << (OECC_CW_LEN-SYMBOL_SIZE*(symbol_index+1));
+        *dirty |= 1u << entry.position; // a miscorrection can hit a clean chip
+        error_chip_position.insert(entry.position);
+    }
+    return entry.result;
+}
+
+
+// residual errors in the codeword(s) of BL : only the dirty chips can hold one
+int SDC_check(int BL, uint64_t *Chip_array, uint32_t dirty, int recc_type)
+{
+
+    int error_check=0;
+    uint64_t check_mask;
+
+    if(recc_type==AMDCHIPKILL) // QPC, OOC : see rs_fault_sim_decode
+        check_mask=SYMBOL_MASK(BL/2); // BL*4 ~ BL*4+7
+    else if(recc_type==RECC_OFF)
+        check_mask=~0ULL;
+    else
+        return error_check;
+
+    for(uint32_t mask=dirty; mask; mask&=mask-1){
+        if(Chip_array[__builtin_ctz(mask)] & check_mask){
+            error_check++;
+            return error_check;
+        }
+    }
+
+    return error_check;
+}
+
+
+/*------------------------------------------------------------------
+                        Binomial confidence intervals
+-------------------------------------------------------------------*/
+// two-sided standard normal quantile z (P(|Z|<z) = confidence), by bisection on erfc
+double normal_quantile(double confidence)
+{
+    double lo=0.0, hi=40.0;
+    for(int iter=0; iter<200; iter++){
+        double mid=(lo+hi)/2;
+        if(erfc(mid/sqrt(2.0)) > 1.0-confidence)
+            lo=mid;
         else
-/* search for words with greatest u_lu[q] for which d[q]!=0 */
-          { q = u-1 ;
-            while ((d[q]==-1) && (q>0)) q-- ;
-/* have found first non-zero d[q]  */
-            if (q>0)
-             { j=q ;
-               do
-               { j-- ;
-                 if ((d[j]!=-1) && (u_lu[q]<u_lu[j]))
-                   q = j ;
-               }while (j>0) ;
-             }
-
-/* have now found q such that d[u]!=0 and u_lu[q] is maximum */
-/* store degree of new elp polynomial */
-            if (l[u]>l[q]+u-q)  l[u+1] = l[u] ;
-            else  l[u+1] = l[q]+u-q ;
-
-/* form new elp(x) */
-            for (i=0; i<nn-QPC_kk; i++)    elp[u+1][i] = 0 ;
-            for (i=0; i<=l[q]; i++)
-              if (elp[q][i]!=-1)
-                elp[u+1][i+u-q] = primitive_poly[0][(d[u]+nn-d[q]+elp[q][i])%nn] ;
-            for (i=0; i<=l[u]; i++)
-              { elp[u+1][i] ^= elp[u][i] ;
-                elp[u][i] = index_of(elp[u][i]) ;  /*convert old elp value to index*/
-              }
-          }
-        u_lu[u+1] = u-l[u+1] ;
-
-/* form (u+1)th discrepancy */
-        if (u<nn-QPC_kk)    /* no discrepancy computed on last iteration */
-          {
-            if (s[u+1]!=-1)
-                   d[u+1] = primitive_poly[0][s[u+1]] ;
-            else
-              d[u+1] = 0 ;
-            for (i=1; i<=l[u+1]; i++)
-              if ((s[u+1-i]!=-1) && (elp[u+1][i]!=0))
-                d[u+1] ^= primitive_poly[0][(s[u+1-i]+index_of(elp[u+1][i]))%nn] ;
-            d[u+1] = index_of(d[u+1]) ;    /* put d[u+1] into index form */
-          }
-      } while ((u<nn-QPC_kk) && (l[u+1]<=QPC_tt)) ;
-
-      u++ ;
-
-      ////////////////////////////////////////////////////
-      // error correction start!!!!!!!!!!!!!!!!!!!!!!!!!
-      ////////////////////////////////////////////////////
-
-      // CE 'or' SDC cases
-      if (l[u]<=QPC_tt)         /* can correct error */
-      {
-/* put elp into index form */
-         for (i=0; i<=l[u]; i++)   elp[u][i] = index_of(elp[u][i]) ;
-
-/* find roots of the error location polynomial -> finding error location */
-        for (i=1; i<=l[u]; i++)
-          reg[i] = elp[u][i];
-        
-        count = 0;
-        for (i=1; i<=nn; i++){  
-          q = 1 ;
-          for (j=1; j<=l[u]; j++)
-            if (reg[j]!=-1){ 
-              reg[j] = (reg[j]+j)%nn;
-              q ^= primitive_poly[0][reg[j]];
-            }
-          if (!q) {        /* store root and error location number indices */
-            root[count] = i;
-            loc[count] = nn-i; // -> error location
-            count++;
-          }
+            hi=mid;
+    }
+    return (lo+hi)/2;
+}
+
+
+// Wilson score interval of k successes out of n trials
+void wilson_interval(long long k, long long n, double z, double *lower, double *upper)
+{
+    if(n==0){
+        *lower=0.0;
+        *upper=1.0;
+        return;
+    }
+    double p=(double)k/(double)n;
+    double z2=z*z;
+    double center=(p+z2/(2.0*n))/(1.0+z2/n);
+    double half_width=z*sqrt(p*(1.0-p)/n+z2/(4.0*n*n))/(1.0+z2/n);
+    *lower=(k>0 && center-half_width>0.0) ? center-half_width : 0.0;
+    *upper=(k<n && center+half_width<1.0) ? center+half_width : 1.0;
+    return;
+}
+
+
+// continued fraction of the regularized incomplete beta function (modified Lentz)
+double beta_continued_fraction(double a, double b, double x)
+{
+    const double tiny=1e-300;
+    double c=1.0, d=1.0-(a+b)*x/(a+1.0);
+    if(fabs(d)<tiny) d=tiny;
+    d=1.0/d;
+    double h=d;
+    for(long long m=1; m<100000000; m++){
+        double aa=m*(b-m)*x/((a+2*m-1)*(a+2*m));
+        d=1.0+aa*d; if(fabs(d)<tiny) d=tiny;
+        c=1.0+aa/c; if(fabs(c)<tiny) c=tiny;
+        d=1.0/d;
+        h*=d*c;
+        aa=-(a+m)*(a+b+m)*x/((a+2*m)*(a+2*m+1));
+        d=1.0+aa*d; if(fabs(d)<tiny) d=tiny;
+        c=1.0+aa/c; if(fabs(c)<tiny) c=tiny;
+        d=1.0/d;
+        double del=d*c;
+        h*=del;
+        if(fabs(del-1.0)<1e-15)
+            break;
+    }
+    return h;
+}
+
+
+// regularized incomplete beta function I_x(a,b)
+double incomplete_beta(double a, double b, double x)
+{
+    if(x<=0.0) return 0.0;
+    if(x>=1.0) return 1.0;
+    double front=exp(lgamma(a+b)-lgamma(a)-lgamma(b)+a*log(x)+b*log1p(-x));
+    if(x<(a+1.0)/(a+b+2.0))
+        return front*beta_continued_fraction(a,b,x)/a;
+    return 1.0-front*beta_continued_fraction(b,a,1.0-x)/b;
+}
+
+
+// x such that I_x(a,b) = target, by bisection
+double inverse_incomplete_beta(double a, double b, double target)
+{
+    double lo=0.0, hi=1.0;
+    for(int iter=0; iter<200; iter++){
+        double mid=(lo+hi)/2;
+        if(incomplete_beta(a,b,mid)<target)
+            lo=mid;
+        else
+            hi=mid;
+    }
+    return (lo+hi)/2;
+}
+
+
+// Clopper-Pearson (exact) interval of k successes out of n trials
+void clopper_pearson_interval(long long k, long long n, double confidence, double *lower, double *upper)
+{
+    double alpha=1.0-confidence;
+    *lower=(k==0) ? 0.0 : inverse_incomplete_beta((double)k, (double)(n-k+1), alpha/2);
+    *upper=(k==n) ? 1.0 : inverse_incomplete_beta((double)(k+1), (double)(n-k), 1.0-alpha/2);
+    return;
+}
+
+
+// importance sampling estimate of a rate and its standard error (sums of w and w^2 over n trials)
+void weighted_estimate(unsigned __int128 weight_sum, unsigned __int128 weight2_sum, long long n, double *rate, double *std_err)
+{
+    double mean=(double)weight_sum/IS_WEIGHT_SCALE/(double)n;
+    double mean2=(double)weight2_sum/IS_WEIGHT_SCALE/(double)n;
+    *rate=mean;
+    *std_err=(n>1 && mean2>mean*mean) ? sqrt((mean2-mean*mean)/(double)(n-1)) : 0.0;
+    return;
+}
+
+
+// true if the Wilson half-width of k/n is within abs_err, or within rel_err of k/n (a target <= 0 is unused)
+bool rate_converged(long long k, long long n, double z, double rel_err, double abs_err)
+{
+    double lower, upper;
+    wilson_interval(k, n, z, &lower, &upper);
+    double half_width=(upper-lower)/2;
+    if(abs_err>0 && half_width<=abs_err)
+        return true;
+    if(rel_err>0 && k>0 && half_width<=rel_err*(double)k/(double)n)
+        return true;
+    return false;
+}
+
+
+// rate_converged() for an importance sampling estimate (normal interval)
+bool weighted_converged(unsigned __int128 weight_sum, unsigned __int128 weight2_sum, long long n, double z, double rel_err, double abs_err)
+{
+    double rate, std_err;
+    weighted_estimate(weight_sum, weight2_sum, n, &rate, &std_err);
+    if(abs_err>0 && z*std_err<=abs_err)
+        return true;
+    if(rel_err>0 && rate>0 && z*std_err<=rel_err*rate)
+        return true;
+    return false;
+}
+
+
+/*------------------------------------------------------------------
+                        Monte Carlo engine
+-------------------------------------------------------------------*/
+struct Fault_sim_result {
+    long long CE_cnt, DUE_cnt, SDC_cnt; // num of CE, DUE, SDC
+    unsigned __int128 weight_sum[4], weight2_sum[4]; // importance sampling : sum of w, w^2 (x IS_WEIGHT_SCALE) per result_type
+};
+
+
+// RECC of every block of an RS codec (modified in place) -> CE/DUE/SDC of the access (worst block)
+template<class Codec>
+int rs_fault_sim_decode(uint64_t *Chip_array, uint32_t dirty)
+{
+    int final_result=CE;
+    for(int block=0; block<Codec::block_num; block++){
+        int syndrome[2*Codec::tt+1];
+        unsigned int codeword[Codec::n_short];
+        int result_type_recc=NE; // only gathered when the syndrome is nonzero
+        if(rs_syndrome_packed<Codec>(Chip_array, dirty, block, syndrome)){
+            gather_codeword<Codec>(Chip_array, dirty, block, codeword);
+            stats_stage(STAGE_GATHER);
+            result_type_recc = error_correction_RS<Codec>(codeword, syndrome);
+            stats_stage(STAGE_DECODE);
+            stats_path((result_type_recc==CE) ? PATH_CE : PATH_DUE);
+            scatter_codeword<Codec>(Chip_array, dirty, block, codeword);
         }
-        
-        int CE_cases=1;
-        //printf("error location check! (shortened RS code!)\n");
-        for(int index=0; index<count; index++){
-          if(loc[index]>=QPC_nn_short) // except for zero-padding part!!
-            CE_cases=0;
+        else{
+            stats_stage(STAGE_GATHER);
+            stats_path(PATH_ZERO);
         }
-        
-        if (l[u]>2){
-            for(int index=0; index<count; index++){
-                if((loc[index] / 4) != (loc[0] / 4)) // except for zero-padding part!!
-                    CE_cases=0;
+
+        // SDC check (residual errors in the block)
+        if(result_type_recc==CE || result_type_recc==NE){
+            for(uint32_t mask=dirty; mask; mask&=mask-1){
+                if(Chip_array[__builtin_ctz(mask)] & Codec::block_mask(block)){
+                    result_type_recc=SDC;
+                    break;
+                }
             }
         }
+        stats_stage(STAGE_SDC);
+        if(result_type_recc==DUE || result_type_recc==SDC)
+            final_result = (final_result > result_type_recc) ? final_result : result_type_recc;
+    }
+    return final_result;
+}
 
-         // CE 'or' SDC cases
-         if (count==l[u] && CE_cases==1){    /* no. roots = degree of elp hence <= tt errors*/
-          //printf("CE 'or' SDC cases\n");
-          //printf("count : %d\n",count);
-/* form polynomial z(x) */
-          for (i=1; i<=l[u]; i++){        /* Z[0] = 1 always - do not need */
-            if ((s[i]!=-1) && (elp[u][i]!=-1))
-              z[i] = primitive_poly[0][s[i]] ^ primitive_poly[0][elp[u][i]];
-            else if ((s[i]!=-1) && (elp[u][i]==-1))
-              z[i] = primitive_poly[0][s[i]] ;
-            else if ((s[i]==-1) && (elp[u][i]!=-1))
-              z[i] = primitive_poly[0][elp[u][i]] ;
-            else
-              z[i] = 0 ;
-            for (j=1; j<i; j++){ 
-              if ((s[j]!=-1) && (elp[u][i-j]!=-1))
-                z[i] ^= primitive_poly[0][(elp[u][i-j] + s[j])%nn];
-            }
-            z[i] = index_of(z[i]);         /* put into index form */
-          }
-
-  /* evaluate errors at locations given by error location numbers loc[i] */
-          for (i=0; i<nn; i++){ 
-            err[i] = 0;
-          }
-
-          for (i=0; i<l[u]; i++){    /* compute numerator of error term first */
-            err[loc[i]] = 1;       /* accounts for z[0] */
-            for (j=1; j<=l[u]; j++){
-              if (z[j]!=-1)
-                err[loc[i]] ^= primitive_poly[0][(z[j]+j*root[i])%nn];
-            }
-            if (err[loc[i]]!=0){
-              err[loc[i]] = index_of(err[loc[i]]);
-                q = 0;     /* form denominator of error term */
-                for (j=0; j<l[u]; j++){
-                  if (j!=i)
-                    q += index_of(1^primitive_poly[0][(loc[j]+root[i])%nn]);
+
+// OECC + RECC on an injected chip configuration (modified in place, dirty : see clear_chips) -> NE/CE/DUE/SDC of the trial
+int fault_sim_decode(uint64_t *Chip_array, uint32_t *dirty, int oecc_type, int recc_type)
+{
+    // 4-3. OECC
+    switch(oecc_type){
+        case OECC_OFF:
+            break;
+        case OECC_ON:{ // every chip corrects its own word before the rank-level ECC
+            int bit_num = (recc_type==OOC) ? OOC_OECC_CW_LEN : OECC_CW_LEN;
+            for(uint32_t mask=*dirty; mask; mask&=mask-1)
+                error_correction_oecc(&Chip_array[__builtin_ctz(mask)], bit_num);
+            break;
+        }
+        default:
+            break;
+    }
+    stats_stage(STAGE_OECC);
+
+    // 4-4. RECC
+    set<int> error_chip_position;
+    int result_type_recc; // NE, CE, DUE, SDC 
+    int final_result=CE, final_result_1=CE;
+    int isConservative=0;        
+    switch(recc_type){
+
+/*------------------------------------------------------------------
+                    QPC, OOC Case
+-------------------------------------------------------------------*/
+
+        case OOC:
+            final_result = rs_fault_sim_decode<OOC_codec>(Chip_array, *dirty);
+            break;
+        case QPC:
+            final_result = rs_fault_sim_decode<QPC_codec>(Chip_array, *dirty);
+            break;
+
+ /*------------------------------------------------------------------
+                    AMD Case
+-------------------------------------------------------------------*/
+
+        case AMDCHIPKILL:{
+            // syndromes of all 8 codewords at once (lane BL/2)
+            uint64_t S0_lanes, S1_lanes, error_lanes=0;
+            amd_syndrome_lanes(Chip_array, *dirty, &S0_lanes, &S1_lanes);
+            for(uint32_t mask=*dirty; mask; mask&=mask-1)
+                error_lanes |= Chip_array[__builtin_ctz(mask)];
+            stats_stage(STAGE_GATHER);
+
+            // 1st memory transfer block
+            for(int BL=0; BL<16; BL+=2){ // BL (Burst Length)<16 
+                if(get_symbol(error_lanes, BL/2)==0){ // error-free beats : NE
+                    stats_path(PATH_ZERO);
+                    continue;
                 }
-                q = q % nn;
-                err[loc[i]] = primitive_poly[0][(err[loc[i]]-q+nn)%nn];
-                recd[loc[i]] ^= err[loc[i]];  /*recd[i] must be in polynomial form */   
-            }
-          }
 
-            for (int symbol_index=0; symbol_index<40; symbol_index++) {
-                if (recd[symbol_index] == 0)
-                    for (int symbol_value_index=0; symbol_value_index<8; symbol_value_index++){
-                        codeword[symbol_index*8+symbol_value_index] = 0;
+                // RECC implimentation
+                result_type_recc = error_correction_AMDCHIPKILL(Chip_array, dirty, BL/2, get_symbol(S0_lanes, BL/2), get_symbol(S1_lanes, BL/2), error_chip_position); 
+                stats_stage(STAGE_DECODE);
+                stats_path((result_type_recc==NE) ? PATH_ZERO : (result_type_recc==CE) ? PATH_CE : PATH_DUE);
+
+                // SDC check
+                if(result_type_recc==CE || result_type_recc==NE){
+                    int error_check=SDC_check(BL, Chip_array, *dirty, recc_type);
+                    if(error_check){
+                        result_type_recc=SDC;
                     }
+                }
+                stats_stage(STAGE_SDC);
+                // DUE check
+                if(result_type_recc==DUE || final_result_1==DUE)
+                    final_result_1=DUE;
+                else{ 
+                    final_result_1 = (final_result_1>result_type_recc) ? final_result_1 : result_type_recc;
+                }
+
+                if(CONSERVATIVE_MODE)
+                    isConservative = (error_chip_position.size()>1) ? 1 : isConservative;                    
             }
 
-          return CE;
-          /*
-          printf("err (error values) : ");
-          for(int index=0; index<nn; index++)
-            printf("%d ",err[index]);
-          printf("\n");
-          */
+            if(final_result_1==NE || final_result_1==CE){
+                final_result_1 = (isConservative) ? DUE : CE;
+            }
+            
+            // final result update
+            final_result = final_result_1;
+            break;
         }
-        // DUE cases
-        else{    /* no. roots != degree of elp => >tt errors and cannot solve */
-          //printf("DUE cases!!!\n");
 
-          return DUE;
+        case RECC_OFF:{
+            int error_check;
+            int BL=0; // trash value
+            error_check = SDC_check(BL, Chip_array, *dirty, recc_type);
+            final_result = (error_check>0) ? SDC : CE;
+            stats_stage(STAGE_SDC);
+            break;
         }
-      }
-    // DUE cases
-     else{         /* elp has degree has degree >tt hence cannot solve */
-       //printf("DUE cases!\n");
-       return DUE;
-     }
-  }
-  // NE 'or' SDC cases
-  else{       /* no non-zero syndromes => no errors: output received codeword */
-    //printf("NE 'or' SDC cases!\n");
-    return NE;
-  }
+        default:
+            break;
+    }
+
+    return final_result;
 }
 
 
 /*------------------------------------------------------------------
-                        AMD Correction
+                    RowHammer row faults
 -------------------------------------------------------------------*/
-int error_correction_AMDCHIPKILL(unsigned int *codeword, set<int> &error_chip_position)
-{
-    // Syndrome 
-    // S0 = (a^exponent0) ^ (a^exponent1) ^ (a^exponent2) ... ^(a^exponent9)
-    // S1 = (a^exponent0) ^ (a^[exponent1+1]) ^ (a^[exponent2+2]) ... ^ (a^[exponent9+9])
-    // S0 
-    unsigned int S0=0,S1=0;
-    for(int symbol_index=0; symbol_index<AMDCHIPKILL_CW_SYMBOL_NUM; symbol_index++){ // 0~9
-        unsigned exponent=255; 
-        unsigned symbol_value=0; // 0000_0000 ~ 1111_1111
-
-        for(int symbol_value_index=0; symbol_value_index<SYMBOL_SIZE; symbol_value_index++){ // 8-bit symbol
-            symbol_value^=(codeword[symbol_index*8+symbol_value_index] << (SYMBOL_SIZE-1-symbol_value_index)); // <<7, <<6, ... <<0
-        }
-        for(int prim_exponent=0; prim_exponent<255; prim_exponent++){
-            if(symbol_value==primitive_poly[0][prim_exponent]){
-                exponent=prim_exponent;
-                break;
-            }
-        }
-        //printf("symbol_index : %d, symbol_value : %d\n",symbol_index, symbol_value);
+// ROWHAMMER : disturbance bit flips over a whole victim row (its ROW_ACCESS_NUM accesses) instead of one access.
+// A cell flips with probability --rh-flip if it is susceptible, which depends on the data pattern (--rh-pattern) :
+//   solid   : victim row charged, aggressor rows discharged -> every cell
+//   checker : victim and aggressors 0101... / 1010... -> every other cell (odd bit positions)
+//   random  : random data, a cell is charged and its aggressor cells opposite with probability 1/4
+// The flips are drawn as gaps between susceptible cells (one random number per flip), so only the accesses
+// with a flip are decoded, one after the other on the same Chip_array and tables.
+// The row is a DUE/SDC when any of its accesses is.
+enum RH_PATTERN {RH_RANDOM=0, RH_SOLID=1, RH_CHECKER=2, RH_PATTERN_NUM=3};
+const char *rh_pattern_name[RH_PATTERN_NUM]={"random", "solid", "checker"};
+double rh_flip=RH_FLIP_PROB; // --rh-flip
+int rh_pattern=RH_RANDOM; // --rh-pattern
+
+// susceptible cells skipped before the next flip (log_q = log(1-p)), at most 'limit'
+inline long long rh_gap(double log_q, long long limit)
+{
+    double u = (double)((sim_rand64()>>11)+1)*0x1.0p-53; // (0, 1]
+    double gap = floor(log(u)/log_q);
+    return (gap < (double)limit) ? (long long)gap : limit;
+}
 
-        if(exponent!=255) // S0 = (a^exponent0) ^ (a^exponent1) ^ (a^exponent2) ... ^(a^exponent9)
-            S0^=primitive_poly[0][exponent];
+
+int rowhammer_trial(uint64_t *Chip_array, uint32_t *dirty, int oecc_type, int recc_type)
+{
+    int bit_num = (recc_type==OOC) ? OOC_OECC_CW_LEN : OECC_CW_LEN;
+    long long access_bit_num = (long long)((recc_type==OOC) ? OOC_CHIP_NUM : CHIP_NUM) * bit_num; // draw_bit_error domain
+    int stride = (rh_pattern==RH_CHECKER) ? 2 : 1; // susceptible cell k : bit k*stride+stride-1 of the row
+    long long cell_num = ROW_ACCESS_NUM*access_bit_num/stride;
+    double p = (rh_pattern==RH_RANDOM) ? rh_flip/4 : rh_flip;
+    if(p<=0)
+        return CE;
+    double log_q = (p<1) ? log1p(-p) : -INFINITY; // p = 1 : every susceptible cell flips
+
+    // flips in row order, decoded access by access
+    int final_result=CE;
+    long long cell=rh_gap(log_q, cell_num);
+    while(cell<cell_num && final_result!=SDC){ // SDC : the worst outcome of a row
+        long long access=(cell*stride+stride-1)/access_bit_num;
+        clear_chips(Chip_array, dirty);
+        for(; cell<cell_num && (cell*stride+stride-1)/access_bit_num==access; cell+=1+rh_gap(log_q, cell_num))
+            set_bit_error((int)((cell*stride+stride-1)%access_bit_num), Chip_array, dirty, recc_type);
+        stats_stage(STAGE_INJECT);
+
+        int result_type_recc=fault_sim_decode(Chip_array, dirty, oecc_type, recc_type);
+        if(result_type_recc==DUE || result_type_recc==SDC)
+            final_result = (final_result > result_type_recc) ? final_result : result_type_recc;
     }
+    return final_result;
+}
+
+
+// one fault injection + decoding (Chip_array : scratch array of the calling worker)
+int fault_sim_trial(uint64_t *Chip_array, uint32_t *dirty, int oecc_type, int fault_type, int recc_type)
+{
+    // Linear block code
+    clear_chips(Chip_array, dirty); 
+    sim_is.anchor_chip=-1;
+    sim_is.weight=1.0;
+    if(fault_type==ROWHAMMER) // whole row (see rowhammer_trial)
+        return rowhammer_trial(Chip_array, dirty, oecc_type, recc_type);
+
 
-    // S1 
-    for(int symbol_index=0; symbol_index<AMDCHIPKILL_CW_SYMBOL_NUM; symbol_index++){ // 0~9
-        unsigned exponent=255;
-        unsigned symbol_value=0; // 0000_0000 ~ 1111_1111
-        for(int symbol_value_index=0; symbol_value_index<SYMBOL_SIZE; symbol_value_index++){ // 8-bit symbol
-            symbol_value^=(codeword[symbol_index*8+symbol_value_index] << (SYMBOL_SIZE-1-symbol_value_index)); // <<7, <<6, ... <<0
+    // 4-2. Error injection
+    vector<int> Fault_Chip_position;
+    while (Fault_Chip_position.size() < 4) {
+        int random_pos = sim_rand_bounded(CHIP_NUM); // 0~39
+        if (std::find(Fault_Chip_position.begin(), Fault_Chip_position.end(), random_pos) == Fault_Chip_position.end()) {
+
+            Fault_Chip_position.push_back(random_pos);
         }
-        for(int prim_exponent=0; prim_exponent<255; prim_exponent++){
-            if(symbol_value==primitive_poly[0][prim_exponent]){
-                exponent=prim_exponent;
-                break;
-            }
+    }
+ 
+    vector<int> Fault_Pin_position;
+    while (Fault_Pin_position.size() < 4) {
+        int random_position = sim_rand_bounded(40); // 0~39
+        if (std::find(Fault_Pin_position.begin(), Fault_Pin_position.end(), random_position) == Fault_Pin_position.end()) {
+            Fault_Pin_position.push_back(random_position);
         }
-        
-        if(exponent!=255) // S1 = (a^exponent0) ^ (a^[exponent1+1]) ^ (a^[exponent2+2]) ... ^ (a^[exponent9+9])
-            S1^=primitive_poly[0][(exponent+symbol_index)%255];
     }
 
-    // S0 = a^p, S1= a^q (a^0 ~ a^254)
-    unsigned int p,q;
-    for(int prim_exponent=0; prim_exponent<255; prim_exponent++){
-        if(S0==primitive_poly[0][prim_exponent])
-            p=prim_exponent;
-        if(S1==primitive_poly[0][prim_exponent])
-            q=prim_exponent;
-    }
-    //printf("S0 : %d(a^%d), S1 : %d(a^%d)\n",S0,p,S1,q);
+    switch (fault_type){
+        case SBE: // 1bit
+            error_injection_SE(Fault_Chip_position[0], Chip_array, dirty, recc_type);
+            break;
+        case PIN_1:
+            error_injection_pin(Fault_Pin_position[0],Chip_array, dirty, recc_type);           
+            break;
 
-    //printf("S0 : %d\n",S0);
-    if(S0==0 && S1==0){ // NE (No Error)
-        return NE;
+        case SCE: 
+            error_injection_CHIPKILL(Fault_Chip_position[0],Chip_array, dirty, recc_type);
+            break;
+        case DBE: 
+            error_injection_DBE(Chip_array, dirty, recc_type);
+            break;
+        case TBE:                 
+            error_injection_TBE(Chip_array, dirty, recc_type);          
+            break;
+        case SCE_SBE:                   
+            error_injection_CHIPKILL(Fault_Chip_position[0],Chip_array, dirty, recc_type); 
+            error_injection_SE(Fault_Chip_position[1], Chip_array, dirty, recc_type); 
+            break;
+        case SCE_DBE:                
+            error_injection_CHIPKILL(Fault_Chip_position[0],Chip_array, dirty, recc_type);                     
+            error_injection_SE(Fault_Chip_position[1], Chip_array, dirty, recc_type); 
+            error_injection_SE(Fault_Chip_position[2], Chip_array, dirty, recc_type);  
+            break;
+
+        case SCE_SCE: 
+            error_injection_CHIPKILL(Fault_Chip_position[0],Chip_array, dirty, recc_type); 
+            error_injection_CHIPKILL(Fault_Chip_position[1],Chip_array, dirty, recc_type); 
+            break;
+        case RANK:
+            error_injection_rank(Chip_array, dirty, recc_type);        
+            break;                                             
+        default:
+            break;
     }
-    
-    // CE 'or' DUE
-    // error chip position
-    int error_symbol_position_recc;
-    error_symbol_position_recc=(q+255-p)%255;
-
-    // Table
-    if(0<=error_symbol_position_recc && error_symbol_position_recc < CHIP_NUM){ // CE (error chip location : 0~9)
-        // printf("CE case! error correction start!\n");
-        //error correction
-        for(int symbol_index=0; symbol_index<SYMBOL_SIZE; symbol_index++){ // 0~7
-            codeword[error_symbol_position_recc*SYMBOL_SIZE+symbol_index]^=getAbit(S0, SYMBOL_SIZE-1-symbol_index); // S0 >> 7, S0 >> 6 ... S0 >> 0
-            //Chip_array[error_symbol_position_recc][BL*4+symbol_index]^=getAbit(S0, SYMBOL_SIZE-1-symbol_index); // S0 >> 7, S0 >> 6 ... S0 >> 0
+
+    stats_stage(STAGE_INJECT);
+    return fault_sim_decode(Chip_array, dirty, oecc_type, recc_type);
+}
+
+
+// trials first_trial ~ first_trial+run_num-1 (trial i always uses random stream i)
+void fault_sim_worker(long long first_trial, long long run_num, uint64_t seed, int oecc_type, int fault_type, int recc_type, Fault_sim_result *result)
+{
+    uint64_t Chip_array[OOC_CHIP_NUM]; // chip configuration (packed, see BIT_MASK)
+    uint32_t dirty=0; // dirty chip mask (see clear_chips)
+    long long CE_cnt=0, DUE_cnt=0, SDC_cnt=0;
+
+    memset(result, 0, sizeof(Fault_sim_result));
+    memset(Chip_array, 0, sizeof(Chip_array));
+    for(long long runtime=0; runtime<run_num; runtime++){
+        if(sim_stats_on)
+            stats_trial_begin(first_trial+runtime);
+        sim_rng.seed(seed, first_trial+runtime);
+        int final_result=fault_sim_trial(Chip_array, &dirty, oecc_type, fault_type, recc_type);
+
+        // 4-5. CE/DUE/SDC check
+        CE_cnt   += (final_result==CE)  ? 1 : 0;
+        DUE_cnt  += (final_result==DUE) ? 1 : 0;
+        SDC_cnt  += (final_result==SDC) ? 1 : 0;
+
+        if(is_bias>0){
+            uint64_t weight = (uint64_t)llround(sim_is.weight*IS_WEIGHT_SCALE);
+            uint64_t weight2 = (uint64_t)llround(sim_is.weight*sim_is.weight*IS_WEIGHT_SCALE);
+            result->weight_sum[final_result] += weight;
+            result->weight2_sum[final_result] += weight2;
         }
-        // printf("CE case! error correction done!\n");     
-        error_chip_position.insert(error_symbol_position_recc);
-        return CE;
     }
-    // Table End!!!!!
-    
-    // DUE
-    return DUE;
+
+    result->CE_cnt=CE_cnt;
+    result->DUE_cnt=DUE_cnt;
+    result->SDC_cnt=SDC_cnt;
+    stats_flush();
+    return;
 }
 
 
-int SDC_check(int BL, unsigned int Chip_array[][OECC_CW_LEN], int recc_type)
+void add_result(Fault_sim_result *total, const Fault_sim_result *result)
 {
+    total->CE_cnt  += result->CE_cnt;
+    total->DUE_cnt += result->DUE_cnt;
+    total->SDC_cnt += result->SDC_cnt;
+    for(int type=0; type<4; type++){
+        total->weight_sum[type] += result->weight_sum[type];
+        total->weight2_sum[type] += result->weight2_sum[type];
+    }
+    return;
+}
 
-    int error_check=0;
 
-    if(recc_type==OOC){
-        for(int Error_chip_pos=0; Error_chip_pos<OOC_CHIP_NUM; Error_chip_pos++){ 
-            for(int Fault_pos=0; Fault_pos<OOC_OECC_CW_LEN; Fault_pos++){ 
-                if(Chip_array[Error_chip_pos][Fault_pos]==1){
-                    error_check++;
-                    return error_check;
-                }
-            }
+// trials first_trial ~ first_trial+run_num-1 split across thread_num workers, added to 'total'
+void run_trials(long long first_trial, long long run_num, int thread_num, uint64_t seed, int oecc_type, int fault_type, int recc_type, Fault_sim_result *total)
+{
+    vector<Fault_sim_result> results(thread_num);
+    vector<thread> workers;
+    for(int thread_id=0; thread_id<thread_num; thread_id++){
+        // trials [run_num*thread_id/thread_num, run_num*(thread_id+1)/thread_num)
+        long long first = first_trial + run_num*thread_id/thread_num;
+        long long num = first_trial + run_num*(thread_id+1)/thread_num - first;
+        workers.push_back(thread(fault_sim_worker, first, num, seed, oecc_type, fault_type, recc_type, &results[thread_id]));
+    }
+    for(int thread_id=0; thread_id<thread_num; thread_id++)
+        workers[thread_id].join();
+
+    // reduction (in thread order)
+    for(int thread_id=0; thread_id<thread_num; thread_id++)
+        add_result(total, &results[thread_id]);
+    return;
+}
+
+
+// command-line options shared by single and sweep mode
+struct Fault_sim_options {
+    int thread_num;
+    uint64_t seed;
+    int seed_set;
+    long long max_run_num, check_interval;
+    double rel_err, abs_err, confidence;
+    double z; // normal quantile of confidence (set by finalize_sim_options)
+    int exhaustive; // enumerate every fault instance instead of sampling (--exhaustive)
+    int shard_id, shard_num; // trials [runs*shard_id/shard_num, runs*(shard_id+1)/shard_num) only (--shard)
+    const char *checkpoint; // checkpoint file (--checkpoint, NULL : none)
+};
+
+void init_sim_options(Fault_sim_options *opt)
+{
+    opt->thread_num=1;
+    opt->seed=0;
+    opt->seed_set=0;
+    opt->max_run_num=RUN_NUM;
+    opt->check_interval=CHECK_INTERVAL;
+    opt->rel_err=0;
+    opt->abs_err=0;
+    opt->confidence=CONFIDENCE;
+    opt->z=0;
+    opt->exhaustive=0;
+    opt->shard_id=0;
+    opt->shard_num=1;
+    opt->checkpoint=NULL;
+    return;
+}
+
+// parses the option at argv[arg], returns the number of arguments used (0 : not an option)
+int parse_sim_option(int argc, char* argv[], int arg, Fault_sim_options *opt)
+{
+    if(strcmp(argv[arg],"--exhaustive")==0){ // --exhaustive : exact fractions (SBE, PIN_1, DBE, TBE, SCE stratified, the other classes are sampled)
+        opt->exhaustive=1;
+        return 1;
+    }
+    if(strcmp(argv[arg],"--stats")==0){ // --stats : throughput, progress, stage cycles, decoder paths (stderr)
+        sim_stats_on=1;
+        return 1;
+    }
+    if(arg+1>=argc)
+        return 0;
+    if(strcmp(argv[arg],"--threads")==0) // --threads N (0 : all hardware threads)
+        opt->thread_num = (atoi(argv[arg+1])>0) ? atoi(argv[arg+1]) : (int)thread::hardware_concurrency();
+    else if(strcmp(argv[arg],"--seed")==0){ // --seed S (default : time)
+        opt->seed = strtoull(argv[arg+1], NULL, 0);
+        opt->seed_set = 1;
+    }
+    else if(strcmp(argv[arg],"--runs")==0) // --runs N (max. iterations, ex) 1e8)
+        opt->max_run_num = (long long)atof(argv[arg+1]);
+    else if(strcmp(argv[arg],"--check-interval")==0) // --check-interval N
+        opt->check_interval = (long long)atof(argv[arg+1]);
+    else if(strcmp(argv[arg],"--rel-err")==0) // --rel-err E : stop when the DUE/SDC half-widths <= E * rate
+        opt->rel_err = atof(argv[arg+1]);
+    else if(strcmp(argv[arg],"--abs-err")==0) // --abs-err W : stop when the DUE/SDC half-widths <= W
+        opt->abs_err = atof(argv[arg+1]);
+    else if(strcmp(argv[arg],"--confidence")==0) // --confidence C (ex) 0.95)
+        opt->confidence = atof(argv[arg+1]);
+    else if(strcmp(argv[arg],"--is-bias")==0) // --is-bias B : importance sampling (0 < B <= IS_BIAS_MAX)
+        is_bias = atof(argv[arg+1]);
+    else if(strcmp(argv[arg],"--shard")==0){ // --shard i/N : i-th of N disjoint trial ranges (single mode)
+        if(sscanf(argv[arg+1], "%d/%d", &opt->shard_id, &opt->shard_num)!=2 || opt->shard_num<1 || opt->shard_id<0 || opt->shard_id>=opt->shard_num){
+            fprintf(stderr,"--shard : expected i/N with 0 <= i < N, got %s\n",argv[arg+1]);
+            exit(1);
         }
     }
-    else if(recc_type==QPC){
-        for(int Error_chip_pos=0; Error_chip_pos<CHIP_NUM; Error_chip_pos++){
-            for(int Fault_pos=32*BL; Fault_pos<32*BL+32; Fault_pos++){ 
-                if(Chip_array[Error_chip_pos][Fault_pos]==1){
-                    error_check++;
-                    return error_check;
-                }
-            }
+    else if(strcmp(argv[arg],"--checkpoint")==0) // --checkpoint FILE : save/resume the counters (single mode)
+        opt->checkpoint = argv[arg+1];
+    else if(strcmp(argv[arg],"--rh-flip")==0) // --rh-flip P : flip probability of a susceptible cell (ROWHAMMER)
+        rh_flip = atof(argv[arg+1]);
+    else if(strcmp(argv[arg],"--rh-pattern")==0){ // --rh-pattern random|solid|checker : data pattern (ROWHAMMER)
+        for(rh_pattern=0; rh_pattern<RH_PATTERN_NUM && strcmp(argv[arg+1], rh_pattern_name[rh_pattern])!=0; rh_pattern++)
+            ;
+        if(rh_pattern==RH_PATTERN_NUM){
+            fprintf(stderr,"--rh-pattern : expected random, solid or checker, got %s\n",argv[arg+1]);
+            exit(1);
         }
     }
-    else if(recc_type==AMDCHIPKILL){
-       for(int Error_chip_pos=0; Error_chip_pos<CHIP_NUM; Error_chip_pos++){ 
-            for(int Fault_pos=BL*4; Fault_pos<(BL+2)*4; Fault_pos++){ 
-                if(Chip_array[Error_chip_pos][Fault_pos]==1){
-                    error_check++;
-                    return error_check;
+    else
+        return 0;
+    return 2;
+}
+
+void finalize_sim_options(Fault_sim_options *opt)
+{
+    if(opt->thread_num<1)
+        opt->thread_num=1;
+    if(opt->check_interval<1)
+        opt->check_interval=1;
+    if(!opt->seed_set)
+        opt->seed=(uint64_t)time(NULL);
+    is_bias = (is_bias<0 || opt->exhaustive) ? 0 : (is_bias>IS_BIAS_MAX) ? IS_BIAS_MAX : is_bias;
+    rh_flip = (rh_flip<0) ? 0 : (rh_flip>1) ? 1 : rh_flip;
+    opt->z=normal_quantile(opt->confidence);
+    return;
+}
+
+// DUE and SDC intervals narrow enough (--rel-err/--abs-err), checked at the end of each round
+bool fault_sim_converged(const Fault_sim_result *total, long long run_num, const Fault_sim_options *opt)
+{
+    if(opt->rel_err<=0 && opt->abs_err<=0)
+        return false;
+    if(is_bias>0)
+        return weighted_converged(total->weight_sum[DUE], total->weight2_sum[DUE], run_num, opt->z, opt->rel_err, opt->abs_err)
+            && weighted_converged(total->weight_sum[SDC], total->weight2_sum[SDC], run_num, opt->z, opt->rel_err, opt->abs_err);
+    return rate_converged(total->DUE_cnt, run_num, opt->z, opt->rel_err, opt->abs_err)
+        && rate_converged(total->SDC_cnt, run_num, opt->z, opt->rel_err, opt->abs_err);
+}
+
+
+/*------------------------------------------------------------------
+                        Exhaustive mode
+-------------------------------------------------------------------*/
+// --exhaustive : every fault instance of the class is decoded once instead of sampling.
+// The instances are equally likely in the sampling model, so the fractions are exact :
+//   SBE : 640 bit positions, DBE : C(640,2) and TBE : C(640,3) sets of bit positions (draw_bit_error domain),
+//   PIN_1 : 40 pins x 2^16 error patterns (pin_error_mask).
+// SCE (2^64 patterns per chip, 2^32 for OOC) is stratified instead, see exhaustive_sce.
+// The other classes (combined faults, RANK, ROWHAMMER) are not supported and fall back to sampling (with a warning).
+// Work items (first bit position or pin) are taken from a shared counter by the threads.
+bool exhaustive_supported(int fault_type)
+{
+    return fault_type==SBE || fault_type==PIN_1 || fault_type==DBE || fault_type==TBE || fault_type==SCE;
+}
+
+
+void count_result(Fault_sim_result *result, int final_result)
+{
+    result->CE_cnt  += (final_result==CE)  ? 1 : 0;
+    result->DUE_cnt += (final_result==DUE) ? 1 : 0;
+    result->SDC_cnt += (final_result==SDC) ? 1 : 0;
+    return;
+}
+
+
+// all instances whose first bit position (PIN_1 : pin) is 'item'
+void exhaustive_item(int item, int oecc_type, int fault_type, int recc_type, Fault_sim_result *result)
+{
+    int domain_num = CHIP_NUM*OECC_CW_LEN; // = OOC_CHIP_NUM*OOC_OECC_CW_LEN
+    uint64_t Chip_array[OOC_CHIP_NUM];
+    uint32_t dirty=0;
+
+    memset(Chip_array, 0, sizeof(Chip_array));
+    switch(fault_type){
+        case SBE:
+            clear_chips(Chip_array, &dirty);
+            set_bit_error(item, Chip_array, &dirty, recc_type);
+            count_result(result, fault_sim_decode(Chip_array, &dirty, oecc_type, recc_type));
+            break;
+        case PIN_1:{
+            uint64_t mask = pin_error_mask(item%4, recc_type), error_bits = 0;
+            do{ // every subset of mask (including no error, as in the trials)
+                clear_chips(Chip_array, &dirty);
+                set_pin_error(item, error_bits, Chip_array, &dirty, recc_type);
+                count_result(result, fault_sim_decode(Chip_array, &dirty, oecc_type, recc_type));
+                error_bits = (error_bits - mask) & mask;
+            }while(error_bits!=0);
+            break;
+        }
+        case DBE:
+            for(int second=item+1; second<domain_num; second++){
+                clear_chips(Chip_array, &dirty);
+                set_bit_error(item, Chip_array, &dirty, recc_type);
+                set_bit_error(second, Chip_array, &dirty, recc_type);
+                count_result(result, fault_sim_decode(Chip_array, &dirty, oecc_type, recc_type));
+            }
+            break;
+        case TBE:
+            for(int second=item+1; second<domain_num; second++){
+                for(int third=second+1; third<domain_num; third++){
+                    clear_chips(Chip_array, &dirty);
+                    set_bit_error(item, Chip_array, &dirty, recc_type);
+                    set_bit_error(second, Chip_array, &dirty, recc_type);
+                    set_bit_error(third, Chip_array, &dirty, recc_type);
+                    count_result(result, fault_sim_decode(Chip_array, &dirty, oecc_type, recc_type));
                 }
             }
+            break;
+        default:
+            break;
+    }
+    return;
+}
+
+
+void exhaustive_worker(atomic<int> *next_item, int item_num, int oecc_type, int fault_type, int recc_type, Fault_sim_result *result)
+{
+    memset(result, 0, sizeof(Fault_sim_result));
+    for(int item=(*next_item)++; item<item_num; item=(*next_item)++)
+        exhaustive_item(item, oecc_type, fault_type, recc_type, result);
+    stats_flush();
+    return;
+}
+
+
+// SCE : the word of the faulty chip (bit_num = 64 bits, 32 for OOC) is uniform over its 2^bit_num patterns.
+// A single-chip error is at most one symbol of every AMDCHIPKILL codeword and at most chip_symbols <= tt symbols
+// of one QPC/OOC group, so the RECC outcome depends on the chip and on which of its symbols are nonzero after OECC,
+// not on their values. Each stratum (chip x nonzero-symbol mask after OECC) is decoded once with a representative
+// pattern and weighted by its exact number of patterns :
+//   pattern_num[mask][syndrome] : patterns whose nonzero symbols are 'mask' with that OECC syndrome (<= 255^8),
+//   OECC flips the bit of the syndrome, which clears symbol j when it held that single bit (pattern_num of mask-j)
+//   and sets it when it was zero.
+static_assert(QPC_codec::chip_symbols<=QPC_codec::tt && OOC_codec::chip_symbols<=OOC_codec::tt, "SCE strata : a chip must be correctable whatever its symbol values");
+
+void exhaustive_sce(int oecc_type, int recc_type, double *fraction, long long *stratum_num)
+{
+    int bit_num = (recc_type==OOC) ? OOC_OECC_CW_LEN : OECC_CW_LEN;
+    int symbol_num = bit_num/8, mask_num = 1<<symbol_num;
+
+    unsigned int syndrome_of[OECC_CW_LEN/8][256]; // OECC syndrome of symbol j holding 'value' (others zero)
+    for(int j=0; j<symbol_num; j++)
+        for(int value=0; value<256; value++){
+            uint64_t word = (uint64_t)value << (56-8*j);
+            syndrome_of[j][value]=0;
+            for(int row=0; row<OECC_REDUN_LEN; row++)
+                syndrome_of[j][value] |= (unsigned int)(__builtin_popcountll(oecc_h_row[row] & word) & 1) << row;
         }
+
+    vector<uint64_t> pattern_num((size_t)mask_num<<OECC_REDUN_LEN, 0); // [mask][syndrome]
+    pattern_num[0]=1;
+    for(int mask=1; mask<mask_num; mask++){ // symbol j added to the patterns of mask-j
+        int j=__builtin_ctz(mask);
+        const uint64_t *from=&pattern_num[(size_t)(mask&(mask-1))<<OECC_REDUN_LEN];
+        uint64_t *to=&pattern_num[(size_t)mask<<OECC_REDUN_LEN];
+        for(int syndrome=0; syndrome<(1<<OECC_REDUN_LEN); syndrome++)
+            if(from[syndrome])
+                for(int value=1; value<256; value++)
+                    to[syndrome^syndrome_of[j][value]] += from[syndrome];
     }
-    else if(recc_type==RECC_OFF){
-        for(int Error_chip_pos=0; Error_chip_pos<CHIP_NUM; Error_chip_pos++){ 
-            for(int Fault_pos=0; Fault_pos<OECC_DATA_LEN; Fault_pos++){
-                if(Chip_array[Error_chip_pos][Fault_pos]==1){
-                    error_check++;
-                    return error_check;
-                }
+
+    vector<unsigned __int128> stratum_weight(mask_num, 0); // patterns per nonzero-symbol mask after OECC
+    for(int mask=0; mask<mask_num; mask++)
+        for(int syndrome=0; syndrome<(1<<OECC_REDUN_LEN); syndrome++){
+            uint64_t num=pattern_num[((size_t)mask<<OECC_REDUN_LEN)+syndrome];
+            int error_pos=oecc_syndrome_pos[syndrome];
+            if(num==0)
+                continue;
+            if(oecc_type!=OECC_ON || error_pos<0 || error_pos>=bit_num){
+                stratum_weight[mask]+=num;
+                continue;
             }
+            int j=error_pos/8, bit_value=0x80>>(error_pos%8);
+            if(!(mask>>j & 1)){
+                stratum_weight[mask|(1<<j)]+=num;
+                continue;
+            }
+            uint64_t cleared=pattern_num[((size_t)(mask&~(1<<j))<<OECC_REDUN_LEN)+(syndrome^syndrome_of[j][bit_value])];
+            stratum_weight[mask&~(1<<j)]+=cleared;
+            stratum_weight[mask]+=num-cleared;
+        }
+
+    unsigned __int128 result_weight[3]={0, 0, 0};
+    uint64_t Chip_array[OOC_CHIP_NUM];
+    uint32_t dirty=0;
+    memset(Chip_array, 0, sizeof(Chip_array));
+    for(int chip=0; chip<CHIP_NUM; chip++)
+        for(int mask=0; mask<mask_num; mask++){
+            clear_chips(Chip_array, &dirty);
+            for(int j=0; j<symbol_num; j++)
+                if(mask>>j & 1)
+                    Chip_array[chip] |= SYMBOL_MASK(j); // representative : every nonzero symbol 0xFF
+            dirty |= 1u << chip;
+            int final_result=fault_sim_decode(Chip_array, &dirty, OECC_OFF, recc_type); // OECC is in the weights
+            result_weight[0] += (final_result==CE)  ? stratum_weight[mask] : 0;
+            result_weight[1] += (final_result==DUE) ? stratum_weight[mask] : 0;
+            result_weight[2] += (final_result==SDC) ? stratum_weight[mask] : 0;
         }
+    stats_flush();
+
+    long double instance_num = (long double)CHIP_NUM*ldexpl(1.0L, bit_num);
+    for(int result=0; result<3; result++)
+        fraction[result] = (double)((long double)result_weight[result]/instance_num);
+    *stratum_num = (long long)CHIP_NUM*mask_num;
+    return;
+}
+
+
+// exact CE/DUE/SDC fractions (fraction[result-CE]) from *decode_num decoded instances, strata for SCE
+// (false : fault class not supported)
+bool run_exhaustive(int thread_num, int oecc_type, int fault_type, int recc_type, double *fraction, long long *decode_num)
+{
+    long long domain_num = CHIP_NUM*OECC_CW_LEN;
+    if(!exhaustive_supported(fault_type))
+        return false;
+    if(fault_type==SCE){
+        exhaustive_sce(oecc_type, recc_type, fraction, decode_num);
+        return true;
     }
 
-    return error_check;
+    Fault_sim_result total;
+    memset(&total, 0, sizeof(total));
+    int item_num = (fault_type==PIN_1) ? CHANNEL_WIDTH : (int)domain_num;
+    long long instance_num = (fault_type==SBE) ? domain_num
+                  : (fault_type==PIN_1) ? (long long)CHANNEL_WIDTH*(1LL<<__builtin_popcountll(pin_error_mask(0, recc_type)))
+                  : (fault_type==DBE) ? domain_num*(domain_num-1)/2
+                  : domain_num*(domain_num-1)*(domain_num-2)/6;
+
+    atomic<int> next_item(0);
+    vector<Fault_sim_result> results(thread_num);
+    vector<thread> workers;
+    for(int thread_id=0; thread_id<thread_num; thread_id++)
+        workers.push_back(thread(exhaustive_worker, &next_item, item_num, oecc_type, fault_type, recc_type, &results[thread_id]));
+    for(int thread_id=0; thread_id<thread_num; thread_id++)
+        workers[thread_id].join();
+    for(int thread_id=0; thread_id<thread_num; thread_id++)
+        add_result(&total, &results[thread_id]);
+    fraction[0] = (double)total.CE_cnt/(double)instance_num;
+    fraction[1] = (double)total.DUE_cnt/(double)instance_num;
+    fraction[2] = (double)total.SDC_cnt/(double)instance_num;
+    *decode_num = instance_num;
+    return true;
 }
 
 
-int main(int argc, char* argv[])
+/*------------------------------------------------------------------
+                        Sweep mode
+-------------------------------------------------------------------*/
+// One process runs a whole OECC x fault x RECC matrix :
+// every configuration is split into work items of SWEEP_CHUNK trials and the workers
+// steal items from each other, so cheap (AMDCHIPKILL) and expensive (OOC) configurations share the cores.
+// Each configuration still runs in rounds of --check-interval trials with the same per-trial streams,
+// so its counts are the same as a single-mode run with the same --seed.
+struct Sweep_config {
+    int oecc_type, fault_type, recc_type;
+    string OECC, FAULT, RECC;
+    bool exhaustive; // enumerated (--exhaustive and exhaustive_supported), sampled otherwise
+    long long run_num; // trials of the finished rounds (decoded instances 'or' strata when enumerated)
+    double exact[3]; // CE, DUE, SDC fractions when enumerated
+    long long round_num; // trials of the running round
+    vector<Fault_sim_result> chunk_results; // running round, one per work item
+    atomic<int> pending; // work items of the running round not finished yet
+    Fault_sim_result total;
+    double elapsed; // seconds from the start of the sweep until the configuration finished
+};
+
+struct Sweep_task {
+    Sweep_config *config;
+    int chunk;
+};
+
+// per-worker deque : the owner takes work from the back, idle workers steal from the front
+struct Sweep_queue {
+    mutex lock;
+    deque<Sweep_task> tasks;
+};
+
+struct Sweep_state {
+    const Fault_sim_options *opt;
+    vector<Sweep_queue> queues;
+    atomic<int> remaining; // configurations not finished yet
+    int config_num;
+    chrono::steady_clock::time_point start;
+};
+
+// 'a,b,c-d' -> values (ex) 0-8 => SBE ~ RANK)
+bool parse_type_list(const char *list, vector<int> &values)
 {
-    ///////////////////////////////////////////////////////////////
-    ///////////////////////////////////////////////////////////////
-    ///////////////////////////////////////////////////////////////
+    const char *p=list;
+    while(*p){
+        char *end;
+        long first=strtol(p, &end, 10), last;
+        if(end==p)
+            return false;
+        last=first;
+        p=end;
+        if(*p=='-'){
+            last=strtol(p+1, &end, 10);
+            if(end==p+1)
+                return false;
+            p=end;
+        }
+        for(long value=first; value<=last; value++)
+            values.push_back((int)value);
+        if(*p==',')
+            p++;
+        else if(*p)
+            return false;
+    }
+    return !values.empty();
+}
 
-    // 0. GF(2^8) primitive polynomial table 
-    FILE *fp=fopen("inputs/GF_2^8__primitive_polynomial.txt","r");
-    int primitive_count=0;
-    while(1){
-        char str_read[100];
-        unsigned int primitive_value=0;
-        fgets(str_read,100,fp);
-        primitive_value=conversion_to_int_format(str_read, 8);
+// next round of 'config' onto the deque of worker_id (the configuration is finished when no trials are left)
+void sweep_schedule_round(Sweep_state *state, Sweep_config *config, int worker_id)
+{
+    long long left = state->opt->max_run_num - config->run_num;
+    if(left<=0 || (config->run_num>0 && fault_sim_converged(&config->total, config->run_num, state->opt))){
+        config->elapsed = chrono::duration<double>(chrono::steady_clock::now()-state->start).count();
+        int remaining = --state->remaining;
+        stats_progress("configurations", state->config_num-remaining, state->config_num, config->elapsed);
+        return;
+    }
+    config->round_num = (left<state->opt->check_interval) ? left : state->opt->check_interval;
+    int chunk_num = (int)((config->round_num+SWEEP_CHUNK-1)/SWEEP_CHUNK);
+    Fault_sim_result zero;
+    memset(&zero, 0, sizeof(zero));
+    config->chunk_results.assign(chunk_num, zero);
+    config->pending = chunk_num;
+
+    lock_guard<mutex> guard(state->queues[worker_id].lock);
+    for(int chunk=0; chunk<chunk_num; chunk++){
+        Sweep_task task={config, chunk};
+        state->queues[worker_id].tasks.push_back(task);
+    }
+    return;
+}
 
-        generate_primitive_poly(primitive_value,8,primitive_count); 
-        primitive_count++;
+// the worker that finishes the last item of a round reduces it (in item order) and schedules the next one
+void sweep_finish_round(Sweep_state *state, Sweep_config *config, int worker_id)
+{
+    for(size_t chunk=0; chunk<config->chunk_results.size(); chunk++)
+        add_result(&config->total, &config->chunk_results[chunk]);
+    config->run_num += config->round_num;
+    sweep_schedule_round(state, config, worker_id);
+    return;
+}
 
-        if(feof(fp))
-            break;
+bool sweep_take_task(Sweep_state *state, int worker_id, Sweep_task *task)
+{
+    int thread_num=(int)state->queues.size();
+    for(int i=0; i<thread_num; i++){
+        Sweep_queue &queue=state->queues[(worker_id+i)%thread_num];
+        lock_guard<mutex> guard(queue.lock);
+        if(queue.tasks.empty())
+            continue;
+        if(i==0){ // own deque
+            *task=queue.tasks.back();
+            queue.tasks.pop_back();
+        }
+        else{ // steal
+            *task=queue.tasks.front();
+            queue.tasks.pop_front();
+        }
+        return true;
     }
-    fclose(fp);
+    return false;
+}
 
-    ///////////////////////////////////////////////////////////////
-    ///////////////////////////////////////////////////////////////
-    ///////////////////////////////////////////////////////////////
+void sweep_worker(Sweep_state *state, int worker_id)
+{
+    const Fault_sim_options *opt=state->opt;
+    while(state->remaining>0){
+        Sweep_task task;
+        if(!sweep_take_task(state, worker_id, &task)){ // other workers are finishing the last items
+            this_thread::sleep_for(chrono::microseconds(100));
+            continue;
+        }
+        Sweep_config *config=task.config;
+        long long first = config->run_num + (long long)task.chunk*SWEEP_CHUNK;
+        long long num = (config->round_num-(long long)task.chunk*SWEEP_CHUNK<SWEEP_CHUNK) ? config->round_num-(long long)task.chunk*SWEEP_CHUNK : SWEEP_CHUNK;
+        fault_sim_worker(first, num, opt->seed, config->oecc_type, config->fault_type, config->recc_type, &config->chunk_results[task.chunk]);
+        if(config->pending.fetch_sub(1)==1)
+            sweep_finish_round(state, config, worker_id);
+    }
+    return;
+}
 
-    // 1. H_Matrix 
-    // OECC (On-die ECC)
-    FILE *fp1=fopen("inputs/H_Matrix_OECC.txt","r");
-    while(1){
-        unsigned int value;
-        for(int row=0; row<OECC_REDUN_LEN; row++){
-            for(int column=0; column<OECC_CW_LEN; column++){
-                fscanf(fp1,"%d ",&value);
-                H_Matrix_OECC[row][column]=value;
-                //printf("%d ",H_Matrix_binary[row][column]);
-            }
+// rates and intervals of one configuration (Wilson, normal for importance sampling, exact for --exhaustive)
+void sweep_estimate(const Sweep_config *config, const Fault_sim_options *opt, double *rate, double *lower, double *upper)
+{
+    long long result_cnt[3]={config->total.CE_cnt, config->total.DUE_cnt, config->total.SDC_cnt};
+    for(int result=0; result<3; result++){
+        if(config->exhaustive){
+            rate[result] = config->exact[result];
+            lower[result] = upper[result] = rate[result];
+        }
+        else if(is_bias>0){
+            double std_err;
+            weighted_estimate(config->total.weight_sum[CE+result], config->total.weight2_sum[CE+result], config->run_num, &rate[result], &std_err);
+            lower[result] = (rate[result]-opt->z*std_err>0) ? rate[result]-opt->z*std_err : 0.0;
+            upper[result] = rate[result]+opt->z*std_err;
+        }
+        else{
+            rate[result] = (double)result_cnt[result]/(double)config->run_num;
+            wilson_interval(result_cnt[result], config->run_num, opt->z, &lower[result], &upper[result]);
         }
-        if(feof(fp1))
-            break;
     }
-    fclose(fp1);
+    return;
+}
 
+// one row per configuration, CSV or JSON (output file name ends with .json)
+void write_sweep_table(FILE *fp, const vector<Sweep_config*> &configs, const Fault_sim_options *opt, bool json)
+{
+    const char *result_name[3]={"CE", "DUE", "SDC"};
+    if(json)
+        fprintf(fp,"[\n");
+    else{
+        fprintf(fp,"oecc,fault,recc,runtime,seed,is_bias,confidence,interval");
+        for(int result=0; result<3; result++)
+            fprintf(fp,",%s,%s_lower,%s_upper",result_name[result],result_name[result],result_name[result]);
+        fprintf(fp,",seconds\n");
+    }
+    for(size_t index=0; index<configs.size(); index++){
+        const Sweep_config *config=configs[index];
+        const char *interval = (config->exhaustive) ? "exact" : (is_bias>0) ? "normal" : "Wilson";
+        double rate[3], lower[3], upper[3];
+        sweep_estimate(config, opt, rate, lower, upper);
+        if(json){
+            fprintf(fp,"  {\"oecc\": \"%s\", \"fault\": \"%s\", \"recc\": \"%s\", \"runtime\": %lld, \"seed\": %llu, \"is_bias\": %g, \"confidence\": %g, \"interval\": \"%s\"",
+                config->OECC.c_str(),config->FAULT.c_str(),config->RECC.c_str(),config->run_num,(unsigned long long)opt->seed,is_bias,opt->confidence,interval);
+            for(int result=0; result<3; result++)
+                fprintf(fp,", \"%s\": %.11e, \"%s_lower\": %.11e, \"%s_upper\": %.11e",result_name[result],rate[result],result_name[result],lower[result],result_name[result],upper[result]);
+            fprintf(fp,", \"seconds\": %.3f}%s\n",config->elapsed,(index+1<configs.size()) ? "," : "");
+        }
+        else{
+            fprintf(fp,"%s,%s,%s,%lld,%llu,%g,%g,%s",config->OECC.c_str(),config->FAULT.c_str(),config->RECC.c_str(),config->run_num,(unsigned long long)opt->seed,is_bias,opt->confidence,interval);
+            for(int result=0; result<3; result++)
+                fprintf(fp,",%.11e,%.11e,%.11e",rate[result],lower[result],upper[result]);
+            fprintf(fp,",%.3f\n",config->elapsed);
+        }
+    }
+    if(json)
+        fprintf(fp,"]\n");
+    return;
+}
 
-    // 2. name of output files
-    string OECC="X", RECC="X", FAULT="X"; 
-    int oecc_type, recc_type, fault_type; // => on-die ECC, Rank-level ECC, fault_type 
-    oecc_recc_fault_type_assignment(OECC, FAULT, RECC, &oecc_type, &fault_type, &recc_type, atoi(argv[1]), atoi(argv[2]), atoi(argv[3]));
-    
-    string Result_file_name = RECC + "_" + FAULT + ".S";
-    if (argc > 4) { // set output directory
-        Result_file_name = string(argv[4]) + "/" + Result_file_name;
+int sweep_main(int argc, char* argv[])
+{
+    vector<int> oecc_list, fault_list, recc_list;
+    if(argc<5 || !parse_type_list(argv[2], oecc_list) || !parse_type_list(argv[3], fault_list) || !parse_type_list(argv[4], recc_list)){
+        fprintf(stderr,"usage : %s --sweep <oecc-list> <fault-list> <recc-list> [options] [output file (.csv/.json)]\n",argv[0]);
+        return 1;
+    }
+    Fault_sim_options opt;
+    init_sim_options(&opt);
+    string Result_file_name = "sweep.csv";
+    for(int arg=5; arg<argc; arg++){
+        int used=parse_sim_option(argc, argv, arg, &opt);
+        if(used>0)
+            arg+=used-1;
+        else
+            Result_file_name = argv[arg];
+    }
+    finalize_sim_options(&opt);
+    if(opt.shard_num>1 || opt.checkpoint){
+        fprintf(stderr,"--shard and --checkpoint are single mode options\n");
+        return 1;
     }
-    FILE *fp3=fopen(Result_file_name.c_str(),"w"); 
 
+    vector<Sweep_config*> configs;
+    for(size_t i=0; i<oecc_list.size(); i++)
+        for(size_t j=0; j<fault_list.size(); j++)
+            for(size_t k=0; k<recc_list.size(); k++){
+                Sweep_config *config=new Sweep_config;
+                config->OECC="X"; config->FAULT="X"; config->RECC="X";
+                oecc_recc_fault_type_assignment(config->OECC, config->FAULT, config->RECC, &config->oecc_type, &config->fault_type, &config->recc_type, oecc_list[i], fault_list[j], recc_list[k]);
+                if(config->OECC=="X" || config->FAULT=="X" || config->RECC=="X"){
+                    fprintf(stderr,"unknown configuration : oecc %d, fault %d, recc %d\n",oecc_list[i],fault_list[j],recc_list[k]);
+                    return 1;
+                }
+                config->exhaustive = opt.exhaustive && exhaustive_supported(config->fault_type);
+                config->run_num=0;
+                config->round_num=0;
+                memset(&config->total, 0, sizeof(config->total));
+                config->elapsed=0;
+                configs.push_back(config);
+            }
 
-    // 3. iteration
-    unsigned int Chip_array[OOC_CHIP_NUM][OECC_CW_LEN]; // chip configuration
+    FILE *fp3=fopen(Result_file_name.c_str(),"w");
+    if(fp3==NULL){
+        fprintf(stderr,"cannot open %s\n",Result_file_name.c_str());
+        return 1;
+    }
+
+    // first rounds dealt round-robin, the rest is balanced by stealing
+    Sweep_state state;
+    state.opt=&opt;
+    state.queues=vector<Sweep_queue>(opt.thread_num);
+    state.start=chrono::steady_clock::now();
+    vector<Sweep_config*> sampled_configs;
+    for(size_t index=0; index<configs.size(); index++){ // --exhaustive : one configuration at a time, enumerated by all threads
+        Sweep_config *config=configs[index];
+        if(!config->exhaustive){
+            sampled_configs.push_back(config);
+            continue;
+        }
+        run_exhaustive(opt.thread_num, config->oecc_type, config->fault_type, config->recc_type, config->exact, &config->run_num);
+        config->elapsed = chrono::duration<double>(chrono::steady_clock::now()-state.start).count();
+    }
+    for(size_t index=0; opt.exhaustive && index<sampled_configs.size(); index++)
+        fprintf(stderr,"warning : --exhaustive does not support %s %s %s, Monte Carlo sampling is used instead\n",
+            sampled_configs[index]->OECC.c_str(),sampled_configs[index]->FAULT.c_str(),sampled_configs[index]->RECC.c_str());
+
+    state.remaining=(int)sampled_configs.size();
+    state.config_num=(int)sampled_configs.size();
+    for(size_t index=0; index<sampled_configs.size(); index++)
+        sweep_schedule_round(&state, sampled_configs[index], (int)(index%opt.thread_num));
+
+    vector<thread> workers;
+    for(int thread_id=0; thread_id<opt.thread_num; thread_id++)
+        workers.push_back(thread(sweep_worker, &state, thread_id));
+    for(int thread_id=0; thread_id<opt.thread_num; thread_id++)
+        workers[thread_id].join();
+
+    bool json = Result_file_name.size()>=5 && Result_file_name.compare(Result_file_name.size()-5, 5, ".json")==0;
+    write_sweep_table(fp3, configs, &opt, json);
+    fclose(fp3);
 
-    int CE_cnt=0, DUE_cnt=0, SDC_cnt=0; // num of CE, DUE, SDC 
-    srand((unsigned int)time(NULL)); 
-    double error_scenario;
-    for(int runtime=0; runtime<RUN_NUM; runtime++){
-        // Linear block code
-        for(int i=0; i<OOC_CHIP_NUM; i++)
-            memset(Chip_array[i], 0, sizeof(unsigned int) * OECC_CW_LEN); 
+    long long trial_num=0;
+    for(size_t index=0; index<configs.size(); index++)
+        trial_num += configs[index]->run_num;
+    stats_report("trials", trial_num, chrono::duration<double>(chrono::steady_clock::now()-state.start).count());
 
+    for(size_t index=0; index<configs.size(); index++)
+        delete configs[index];
+    return 0;
+}
 
-        // 4-2. Error injection
-        vector<int> Fault_Chip_position;
-        while (Fault_Chip_position.size() < 4) {
-            int random_pos = rand() % CHIP_NUM; // 0~39
-            if (std::find(Fault_Chip_position.begin(), Fault_Chip_position.end(), random_pos) == Fault_Chip_position.end()) {
 
-                Fault_Chip_position.push_back(random_pos);
-            }
+/*------------------------------------------------------------------
+                        Lifetime mode
+-------------------------------------------------------------------*/
+// --lifetime : system-level DUE/SDC rates of a rank over its service life instead of P(result | fault).
+// Faults arrive as a Poisson process with the per-device FIT rates below (CHIP_NUM devices per rank),
+// so the fault-free time to the next arrival is drawn directly (exponential) instead of stepping through it.
+// Every fault has a footprint : the accesses (bank, row, column) it corrupts, drawn at arrival, with the
+// error pattern of the single-mode injector (chip, pin 'or' bit drawn there) in each of them :
+//   SBE : one access, COLUMN : one column of a bank (pin pattern), ROW : one row of a bank,
+//   BANK : every access to a bank, CHIP : every access (multi-bank) (chip pattern), RANK : every access (rank pattern).
+// An arrival is decoded together with the faults still present only in the accesses they share :
+// one decode per distinct set of faults that meet in an access (faults that meet nowhere are decoded alone).
+//   permanent faults stay until the end of the lifetime, transient faults are removed by the next patrol scrub.
+// A rank ends its service at its first DUE 'or' SDC (replaced), otherwise at the end of the lifetime.
+// Rank r uses random stream r, so the counts do not depend on --threads.
+enum LIFETIME_CLASS {LT_SBE=0, LT_COLUMN=1, LT_ROW=2, LT_BANK=3, LT_CHIP=4, LT_RANK=5, LIFETIME_CLASS_NUM=6};
+enum FOOTPRINT_DIM {DIM_BANK=0, DIM_ROW=1, DIM_COLUMN=2, DIM_NUM=3};
+
+// per-device FIT (failures in 1e9 device-hours), transient / permanent : DRAM field rates
+// (single-bit, single-column, single-row, single-bank, multi-bank, multi-rank)
+double lifetime_fit[LIFETIME_CLASS_NUM][2] = {{14.2, 18.6}, {1.4, 5.6}, {0.2, 8.2}, {0.8, 10.0}, {0.3, 1.4}, {0.9, 2.8}};
+
+// footprint dimensions a class fixes at arrival (the others cover the whole bank, row 'or' column range)
+const bool lifetime_footprint_fixed[LIFETIME_CLASS_NUM][DIM_NUM] = {
+    {true, true, true}, {true, false, true}, {true, true, false}, {true, false, false}, {false, false, false}, {false, false, false}};
+const int footprint_dim_size[DIM_NUM] = {RANK_BANK_NUM, BANK_ROW_NUM, ROW_ACCESS_NUM};
+
+struct Lifetime_result {
+    long long rank_num, fault_num, DUE_cnt, SDC_cnt;
+    long long service_seconds; // in-service time of the ranks (integer seconds : same sums at any thread count)
+};
+
+struct Lifetime_fault {
+    int address[DIM_NUM]; // bank, row, column (-1 : any)
+    bool permanent;
+    uint64_t Chip_array[OOC_CHIP_NUM]; // error pattern in every access of the footprint
+    uint32_t dirty;
+};
+
+// the access 'address' (-1 : a value that no fixed footprint uses) is in the footprint of 'fault'
+bool footprint_contains(const Lifetime_fault &fault, const int *address)
+{
+    for(int dim=0; dim<DIM_NUM; dim++)
+        if(fault.address[dim]>=0 && fault.address[dim]!=address[dim])
+            return false;
+    return true;
+}
+
+bool footprint_overlap(const Lifetime_fault &fault, const Lifetime_fault &other)
+{
+    for(int dim=0; dim<DIM_NUM; dim++)
+        if(fault.address[dim]>=0 && other.address[dim]>=0 && fault.address[dim]!=other.address[dim])
+            return false;
+    return true;
+}
+
+
+// the new fault (last of 'faults') in every access of its footprint -> CE, DUE 'or' SDC (worst access)
+// Every access of the footprint is equivalent to one of the candidate addresses : per dimension, the fixed value of the
+// new fault, 'or' the fixed values of the overlapping faults plus -1 (any other value, only covered by 'any').
+int lifetime_decode(uint64_t *Chip_array, const vector<Lifetime_fault> &faults, int oecc_type, int recc_type)
+{
+    const Lifetime_fault &fault=faults.back();
+    vector<int> overlap; // present faults sharing an access with the new one
+    for(size_t index=0; index+1<faults.size(); index++)
+        if(footprint_overlap(fault, faults[index]))
+            overlap.push_back((int)index);
+
+    vector<int> candidate[DIM_NUM];
+    for(int dim=0; dim<DIM_NUM; dim++){
+        candidate[dim].push_back(fault.address[dim]);
+        if(fault.address[dim]>=0)
+            continue;
+        for(size_t index=0; index<overlap.size(); index++){
+            int value=faults[overlap[index]].address[dim];
+            if(value>=0 && find(candidate[dim].begin(), candidate[dim].end(), value)==candidate[dim].end())
+                candidate[dim].push_back(value);
         }
-     
-        vector<int> Fault_Pin_position;
-        while (Fault_Pin_position.size() < 4) {
-            int random_position = rand() % 40; // 0~39
-            if (std::find(Fault_Pin_position.begin(), Fault_Pin_position.end(), random_position) == Fault_Pin_position.end()) {
-                Fault_Pin_position.push_back(random_position);
+    }
+
+    int final_result=CE;
+    uint32_t dirty=0;
+    vector<vector<bool>> decoded; // fault sets already decoded (membership of the overlapping faults)
+    for(size_t bank=0; bank<candidate[DIM_BANK].size(); bank++){
+        for(size_t row=0; row<candidate[DIM_ROW].size(); row++){
+            for(size_t column=0; column<candidate[DIM_COLUMN].size(); column++){
+                int address[DIM_NUM]={candidate[DIM_BANK][bank], candidate[DIM_ROW][row], candidate[DIM_COLUMN][column]};
+                vector<bool> member(overlap.size());
+                for(size_t index=0; index<overlap.size(); index++)
+                    member[index]=footprint_contains(faults[overlap[index]], address);
+                if(find(decoded.begin(), decoded.end(), member)!=decoded.end())
+                    continue;
+                decoded.push_back(member);
+
+                // faults of this access (the decoder works on a copy)
+                clear_chips(Chip_array, &dirty);
+                for(uint32_t mask=fault.dirty; mask; mask&=mask-1)
+                    Chip_array[__builtin_ctz(mask)] = fault.Chip_array[__builtin_ctz(mask)];
+                dirty=fault.dirty;
+                for(size_t index=0; index<overlap.size(); index++){
+                    if(!member[index])
+                        continue;
+                    const Lifetime_fault &other=faults[overlap[index]];
+                    for(uint32_t mask=other.dirty; mask; mask&=mask-1)
+                        Chip_array[__builtin_ctz(mask)] |= other.Chip_array[__builtin_ctz(mask)];
+                    dirty |= other.dirty;
+                }
+                int result=fault_sim_decode(Chip_array, &dirty, oecc_type, recc_type);
+                if(result==DUE || result==SDC)
+                    final_result = (final_result > result) ? final_result : result;
             }
         }
+    }
+    clear_chips(Chip_array, &dirty);
+    return final_result;
+}
 
-        switch (fault_type){
-            case SBE: // 1bit
-                error_injection_SE(Fault_Chip_position[0], Chip_array, recc_type);
-                break;
-            case PIN_1:
-                error_injection_pin(Fault_Pin_position[0],Chip_array, recc_type);           
-                break;
 
-            case SCE: 
-                error_injection_CHIPKILL(Fault_Chip_position[0],Chip_array, recc_type);
-                break;
-            case DBE: 
-                error_injection_DBE(Chip_array, recc_type);
-                break;
-            case TBE:                 
-                error_injection_TBE(Chip_array, recc_type);          
+// one rank over 'hours' (scrub : patrol scrub interval) -> NE (no failure), DUE 'or' SDC ; *service : in-service hours
+// (faults : scratch list of the calling worker)
+int lifetime_trial(uint64_t *Chip_array, vector<Lifetime_fault> *faults, int oecc_type, int recc_type, double hours, double scrub, double *service, int *fault_num)
+{
+    double rate[LIFETIME_CLASS_NUM*2], total_rate=0; // per hour, per rank
+    for(int fault_class=0; fault_class<LIFETIME_CLASS_NUM*2; fault_class++){
+        rate[fault_class] = lifetime_fit[fault_class/2][fault_class%2]*CHIP_NUM/1e9;
+        total_rate += rate[fault_class];
+    }
+
+    double now=0;
+    *fault_num=0;
+    faults->clear();
+    while(1){
+        // time to the next fault (1-U in (0,1])
+        double next = now - log(1.0-(double)(sim_rand64()>>11)*0x1.0p-53)/total_rate;
+        if(next>=hours)
+            break;
+        if(floor(next/scrub)!=floor(now/scrub)){ // scrubbed since the last fault : keep the permanent faults
+            size_t kept=0;
+            for(size_t index=0; index<faults->size(); index++)
+                if((*faults)[index].permanent)
+                    (*faults)[kept++]=(*faults)[index];
+            faults->resize(kept);
+        }
+        now=next;
+        (*fault_num)++;
+
+        // fault class (rate-weighted), footprint and error pattern
+        double pick = (double)(sim_rand64()>>11)*0x1.0p-53*total_rate;
+        int fault_class=0;
+        while(fault_class<LIFETIME_CLASS_NUM*2-1 && pick>=rate[fault_class])
+            pick -= rate[fault_class++];
+
+        faults->emplace_back();
+        Lifetime_fault &fault=faults->back();
+        fault.permanent = (fault_class%2)==1;
+        for(int dim=0; dim<DIM_NUM; dim++)
+            fault.address[dim] = lifetime_footprint_fixed[fault_class/2][dim] ? sim_rand_bounded(footprint_dim_size[dim]) : -1;
+        memset(fault.Chip_array, 0, sizeof(fault.Chip_array));
+        fault.dirty=0;
+        sim_is.anchor_chip=-1;
+        sim_is.weight=1.0;
+        switch(fault_class/2){
+            case LT_SBE:
+                error_injection_SE(sim_rand_bounded(CHIP_NUM), fault.Chip_array, &fault.dirty, recc_type);
                 break;
-            case SCE_SBE:                   
-                error_injection_CHIPKILL(Fault_Chip_position[0],Chip_array, recc_type); 
-                error_injection_SE(Fault_Chip_position[1], Chip_array, recc_type); 
+            case LT_COLUMN:
+                error_injection_pin(sim_rand_bounded(CHANNEL_WIDTH), fault.Chip_array, &fault.dirty, recc_type);
                 break;
-            case SCE_DBE:                
-                error_injection_CHIPKILL(Fault_Chip_position[0],Chip_array, recc_type);                     
-                error_injection_SE(Fault_Chip_position[1], Chip_array, recc_type); 
-                error_injection_SE(Fault_Chip_position[2], Chip_array, recc_type);  
+            case LT_ROW:
+            case LT_BANK:
+            case LT_CHIP:
+                error_injection_CHIPKILL(sim_rand_bounded(CHIP_NUM), fault.Chip_array, &fault.dirty, recc_type);
                 break;
-
-            case SCE_SCE: 
-                error_injection_CHIPKILL(Fault_Chip_position[0],Chip_array, recc_type); 
-                error_injection_CHIPKILL(Fault_Chip_position[1],Chip_array, recc_type); 
+            case LT_RANK:
+                error_injection_rank(fault.Chip_array, &fault.dirty, recc_type);
                 break;
-            case RANK:
-                error_injection_rank(Chip_array, recc_type);        
-                break;                                             
             default:
                 break;
         }
 
-        // 4-3. OECC
-        switch(oecc_type){
-            case OECC_OFF:
-                break;
-            case OECC_ON:
-                break;
-            default:
-                break;
+        int final_result=lifetime_decode(Chip_array, *faults, oecc_type, recc_type);
+        if(final_result==DUE || final_result==SDC){
+            *service=now;
+            return final_result;
         }
+    }
+    *service=hours;
+    return NE;
+}
 
-        // 4-4. RECC
-        set<int> error_chip_position;
-        int result_type_recc; // NE, CE, DUE, SDC 
-        int final_result, final_result_1=CE,final_result_2=CE;
-        int Chip_idx=0;
-        int isConservative=0;        
-        switch(recc_type){
 
-/*------------------------------------------------------------------
-                        OOC Case
--------------------------------------------------------------------*/
+// ranks first_rank ~ first_rank+rank_num-1 (rank i always uses random stream i)
+void lifetime_worker(long long first_rank, long long rank_num, uint64_t seed, int oecc_type, int recc_type, double hours, double scrub, Lifetime_result *result)
+{
+    uint64_t Chip_array[OOC_CHIP_NUM];
+    vector<Lifetime_fault> faults;
+    memset(result, 0, sizeof(Lifetime_result));
+    memset(Chip_array, 0, sizeof(Chip_array));
+    for(long long rank=0; rank<rank_num; rank++){
+        sim_rng.seed(seed, first_rank+rank);
+        double service;
+        int fault_num;
+        int final_result=lifetime_trial(Chip_array, &faults, oecc_type, recc_type, hours, scrub, &service, &fault_num);
+
+        result->rank_num++;
+        result->fault_num += fault_num;
+        result->DUE_cnt += (final_result==DUE) ? 1 : 0;
+        result->SDC_cnt += (final_result==SDC) ? 1 : 0;
+        result->service_seconds += llround(service*3600);
+    }
+    stats_flush();
+    return;
+}
 
-            case OOC:
-                // 1st memory transfer block
-                unsigned int codeword_OOC[OOC_CW_LEN];
-                Chip_idx=0;
-                while(Chip_idx<OOC_CHIP_NUM){
-                    for(int Pin_num=0; Pin_num<CHIP_WIDTH; Pin_num++){
-                        codeword_OOC[Chip_idx*32+Pin_num*8]=Chip_array[Chip_idx][Pin_num*8];
-                        codeword_OOC[Chip_idx*32+Pin_num*8+1]=Chip_array[Chip_idx][Pin_num*8+1];
-                        codeword_OOC[Chip_idx*32+Pin_num*8+2]=Chip_array[Chip_idx][Pin_num*8+2];
-                        codeword_OOC[Chip_idx*32+Pin_num*8+3]=Chip_array[Chip_idx][Pin_num*8+3];
-                        codeword_OOC[Chip_idx*32+Pin_num*8+4]=Chip_array[Chip_idx][Pin_num*8+4];
-                        codeword_OOC[Chip_idx*32+Pin_num*8+5]=Chip_array[Chip_idx][Pin_num*8+5];
-                        codeword_OOC[Chip_idx*32+Pin_num*8+6]=Chip_array[Chip_idx][Pin_num*8+6];
-                        codeword_OOC[Chip_idx*32+Pin_num*8+7]=Chip_array[Chip_idx][Pin_num*8+7];
-                    }
-                    Chip_idx++;
-                }
 
-                // RECC implimentation
-                result_type_recc = error_correction_OOC(codeword_OOC); 
-
-                Chip_idx=0;
-                while(Chip_idx<OOC_CHIP_NUM){
-                    for(int Pin_num=0; Pin_num<CHIP_WIDTH; Pin_num++){                        
-                        Chip_array[Chip_idx][Pin_num*8]=codeword_OOC[Chip_idx*32+Pin_num*8];
-                        Chip_array[Chip_idx][Pin_num*8+1]=codeword_OOC[Chip_idx*32+Pin_num*8+1];
-                        Chip_array[Chip_idx][Pin_num*8+2]=codeword_OOC[Chip_idx*32+Pin_num*8+2];
-                        Chip_array[Chip_idx][Pin_num*8+3]=codeword_OOC[Chip_idx*32+Pin_num*8+3];
-                        Chip_array[Chip_idx][Pin_num*8+4]=codeword_OOC[Chip_idx*32+Pin_num*8+4];
-                        Chip_array[Chip_idx][Pin_num*8+5]=codeword_OOC[Chip_idx*32+Pin_num*8+5];
-                        Chip_array[Chip_idx][Pin_num*8+6]=codeword_OOC[Chip_idx*32+Pin_num*8+6];
-                        Chip_array[Chip_idx][Pin_num*8+7]=codeword_OOC[Chip_idx*32+Pin_num*8+7];
-                    }
-                    Chip_idx++;
-                }
+void run_lifetime(long long first_rank, long long rank_num, int thread_num, uint64_t seed, int oecc_type, int recc_type, double hours, double scrub, Lifetime_result *total)
+{
+    vector<Lifetime_result> results(thread_num);
+    vector<thread> workers;
+    for(int thread_id=0; thread_id<thread_num; thread_id++){
+        long long first = first_rank + rank_num*thread_id/thread_num;
+        long long num = first_rank + rank_num*(thread_id+1)/thread_num - first;
+        workers.push_back(thread(lifetime_worker, first, num, seed, oecc_type, recc_type, hours, scrub, &results[thread_id]));
+    }
+    for(int thread_id=0; thread_id<thread_num; thread_id++)
+        workers[thread_id].join();
+    for(int thread_id=0; thread_id<thread_num; thread_id++){
+        total->rank_num += results[thread_id].rank_num;
+        total->fault_num += results[thread_id].fault_num;
+        total->DUE_cnt += results[thread_id].DUE_cnt;
+        total->SDC_cnt += results[thread_id].SDC_cnt;
+        total->service_seconds += results[thread_id].service_seconds;
+    }
+    return;
+}
 
-                // SDC check
-                if(result_type_recc==CE || result_type_recc==NE){
-                    int error_check=SDC_check(0, Chip_array, recc_type);
-                    if(error_check){
-                        final_result_1=SDC;
-                    }
+
+int lifetime_main(int argc, char* argv[])
+{
+    vector<int> oecc_list, recc_list;
+    if(argc<4 || !parse_type_list(argv[2], oecc_list) || !parse_type_list(argv[3], recc_list)){
+        fprintf(stderr,"usage : %s --lifetime <oecc-list> <recc-list> [--years Y] [--scrub-hours H] [--fit SBE,COLUMN,ROW,BANK,CHIP,RANK] [options] [output file (.csv/.json)]\n",argv[0]);
+        return 1;
+    }
+    Fault_sim_options opt;
+    init_sim_options(&opt);
+    double years=LIFETIME_YEARS, scrub=SCRUB_HOURS;
+    string Result_file_name = "lifetime.csv";
+    for(int arg=4; arg<argc; arg++){
+        if(arg+1<argc && strcmp(argv[arg],"--years")==0) // --years Y : service life
+            years = atof(argv[++arg]);
+        else if(arg+1<argc && strcmp(argv[arg],"--scrub-hours")==0) // --scrub-hours H : patrol scrub interval
+            scrub = atof(argv[++arg]);
+        else if(arg+1<argc && strcmp(argv[arg],"--fit")==0){ // --fit a,b,c,d,e,f : FIT per device and class (transient share kept)
+            const char *list=argv[++arg];
+            char *next=(char*)list;
+            double fit[LIFETIME_CLASS_NUM];
+            for(int fault_class=0; fault_class<LIFETIME_CLASS_NUM; fault_class++){
+                char *end;
+                fit[fault_class]=strtod(next, &end);
+                if(end==next || fit[fault_class]<0 || *end!=((fault_class<LIFETIME_CLASS_NUM-1) ? ',' : '\0')){
+                    fprintf(stderr,"--fit %s : expected %d comma-separated FIT values (SBE,COLUMN,ROW,BANK,CHIP,RANK)\n",list,LIFETIME_CLASS_NUM);
+                    return 1;
                 }
+                next = end+1;
+            }
+            for(int fault_class=0; fault_class<LIFETIME_CLASS_NUM; fault_class++){
+                double sum=lifetime_fit[fault_class][0]+lifetime_fit[fault_class][1];
+                double transient_share = (sum>0) ? lifetime_fit[fault_class][0]/sum : 0;
+                lifetime_fit[fault_class][0]=fit[fault_class]*transient_share;
+                lifetime_fit[fault_class][1]=fit[fault_class]*(1-transient_share);
+            }
+        }
+        else{
+            int used=parse_sim_option(argc, argv, arg, &opt);
+            if(used>0)
+                arg+=used-1;
+            else
+                Result_file_name = argv[arg];
+        }
+    }
+    opt.exhaustive=0;
+    finalize_sim_options(&opt);
+    if(opt.shard_num>1 || opt.checkpoint){
+        fprintf(stderr,"--shard and --checkpoint are single mode options\n");
+        return 1;
+    }
+    is_bias=0; // plain Monte Carlo (the arrivals are not biased)
+    double hours=years*HOURS_PER_YEAR;
+    if(scrub<=0)
+        scrub=hours;
+
+    FILE *fp3=fopen(Result_file_name.c_str(),"w");
+    if(fp3==NULL){
+        fprintf(stderr,"cannot open %s\n",Result_file_name.c_str());
+        return 1;
+    }
+    bool json = Result_file_name.size()>=5 && Result_file_name.compare(Result_file_name.size()-5, 5, ".json")==0;
+    fprintf(fp3, json ? "[\n" : "oecc,recc,ranks,years,scrub_hours,seed,confidence,faults_per_rank,DUE_FIT,SDC_FIT,DUE,DUE_lower,DUE_upper,SDC,SDC_lower,SDC_upper,seconds\n");
+
+    chrono::steady_clock::time_point start=chrono::steady_clock::now();
+    long long rank_sum=0;
+    for(size_t i=0; i<oecc_list.size(); i++){
+        for(size_t k=0; k<recc_list.size(); k++){
+            string OECC="X", FAULT="X", RECC="X";
+            int oecc_type, fault_type, recc_type;
+            oecc_recc_fault_type_assignment(OECC, FAULT, RECC, &oecc_type, &fault_type, &recc_type, oecc_list[i], SBE, recc_list[k]);
+            if(OECC=="X" || RECC=="X"){
+                fprintf(stderr,"unknown configuration : oecc %d, recc %d\n",oecc_list[i],recc_list[k]);
+                fclose(fp3);
+                return 1;
+            }
 
-                // DUE check
-                if(result_type_recc==DUE)
-                    final_result_1=DUE;
- 
+            // rounds of --check-interval ranks until --runs ranks or converged DUE/SDC probabilities
+            Lifetime_result total;
+            memset(&total, 0, sizeof(total));
+            while(total.rank_num<opt.max_run_num){
+                long long round_num = (opt.max_run_num-total.rank_num<opt.check_interval) ? opt.max_run_num-total.rank_num : opt.check_interval;
+                run_lifetime(total.rank_num, round_num, opt.thread_num, opt.seed, oecc_type, recc_type, hours, scrub, &total);
+                stats_progress("ranks", total.rank_num, opt.max_run_num, chrono::duration<double>(chrono::steady_clock::now()-start).count());
+                if((opt.rel_err>0 || opt.abs_err>0)
+                   && rate_converged(total.DUE_cnt, total.rank_num, opt.z, opt.rel_err, opt.abs_err)
+                   && rate_converged(total.SDC_cnt, total.rank_num, opt.z, opt.rel_err, opt.abs_err))
+                    break;
+            }
 
-                // final result update
-                final_result = final_result_1; 
-                break;
+            // FIT : failures in 1e9 in-service rank-hours, probabilities : failure within the lifetime
+            double service_hours=(double)total.service_seconds/3600;
+            double fit[2]={total.DUE_cnt/service_hours*1e9, total.SDC_cnt/service_hours*1e9};
+            long long result_cnt[2]={total.DUE_cnt, total.SDC_cnt};
+            double rate[2], lower[2], upper[2];
+            for(int result=0; result<2; result++){
+                rate[result]=(double)result_cnt[result]/(double)total.rank_num;
+                wilson_interval(result_cnt[result], total.rank_num, opt.z, &lower[result], &upper[result]);
+            }
+            double elapsed=chrono::duration<double>(chrono::steady_clock::now()-start).count();
+            rank_sum += total.rank_num;
+            if(json)
+                fprintf(fp3,"%s  {\"oecc\": \"%s\", \"recc\": \"%s\", \"ranks\": %lld, \"years\": %g, \"scrub_hours\": %g, \"seed\": %llu, \"confidence\": %g, \"faults_per_rank\": %.6e, "
+                        "\"DUE_FIT\": %.6e, \"SDC_FIT\": %.6e, \"DUE\": %.11e, \"DUE_lower\": %.11e, \"DUE_upper\": %.11e, \"SDC\": %.11e, \"SDC_lower\": %.11e, \"SDC_upper\": %.11e, \"seconds\": %.3f}",
+                        (i+k>0) ? ",\n" : "",OECC.c_str(),RECC.c_str(),total.rank_num,years,scrub,(unsigned long long)opt.seed,opt.confidence,(double)total.fault_num/(double)total.rank_num,
+                        fit[0],fit[1],rate[0],lower[0],upper[0],rate[1],lower[1],upper[1],elapsed);
+            else
+                fprintf(fp3,"%s,%s,%lld,%g,%g,%llu,%g,%.6e,%.6e,%.6e,%.11e,%.11e,%.11e,%.11e,%.11e,%.11e,%.3f\n",
+                        OECC.c_str(),RECC.c_str(),total.rank_num,years,scrub,(unsigned long long)opt.seed,opt.confidence,(double)total.fault_num/(double)total.rank_num,
+                        fit[0],fit[1],rate[0],lower[0],upper[0],rate[1],lower[1],upper[1],elapsed);
+        }
+    }
+    if(json)
+        fprintf(fp3,"\n]\n");
+    fclose(fp3);
+    stats_report("ranks", rank_sum, chrono::duration<double>(chrono::steady_clock::now()-start).count());
+    return 0;
+}
 
- /*------------------------------------------------------------------
-                        QPC Case
+
+/*------------------------------------------------------------------
+                    Checkpoints, shards and merging
 -------------------------------------------------------------------*/
+// --checkpoint FILE : single mode saves its counters after every round (FILE.tmp, then renamed over FILE),
+// and a rerun with the same FILE resumes after the last saved round. Trial i always uses random stream i,
+// so the number of finished trials is the whole random state of a run.
+// --shard i/N : the run only covers trials [runs*i/N, runs*(i+1)/N) of the seed, so N processes (any hosts)
+// cover disjoint trial ranges ; --merge adds up their checkpoints into the result of the whole run.
+struct Fault_sim_partial {
+    string OECC, FAULT, RECC;
+    uint64_t seed;
+    double is_bias;
+    long long first_trial, run_num; // trials first_trial ~ first_trial+run_num-1
+    int finished; // run_num reached the shard size 'or' converged
+    Fault_sim_result total;
+};
+
+void write_u128(FILE *fp, unsigned __int128 value)
+{
+    fprintf(fp," %016llx%016llx",(unsigned long long)(value>>64),(unsigned long long)value);
+    return;
+}
 
-            case QPC:
-                // 1st memory transfer block
-
-                unsigned int codeword[QPC_CW_LEN];
-                Chip_idx=0;
-                while(Chip_idx<CHIP_NUM){
-                    for(int Pin_num=0; Pin_num<CHIP_WIDTH; Pin_num++){
-                        codeword[Chip_idx*32+Pin_num*8]=Chip_array[Chip_idx][Pin_num*8];
-                        codeword[Chip_idx*32+Pin_num*8+1]=Chip_array[Chip_idx][Pin_num*8+1];
-                        codeword[Chip_idx*32+Pin_num*8+2]=Chip_array[Chip_idx][Pin_num*8+2];
-                        codeword[Chip_idx*32+Pin_num*8+3]=Chip_array[Chip_idx][Pin_num*8+3];
-                        codeword[Chip_idx*32+Pin_num*8+4]=Chip_array[Chip_idx][Pin_num*8+4];
-                        codeword[Chip_idx*32+Pin_num*8+5]=Chip_array[Chip_idx][Pin_num*8+5];
-                        codeword[Chip_idx*32+Pin_num*8+6]=Chip_array[Chip_idx][Pin_num*8+6];
-                        codeword[Chip_idx*32+Pin_num*8+7]=Chip_array[Chip_idx][Pin_num*8+7];
-                    }
-                    Chip_idx++;
-                }
+bool read_u128(FILE *fp, unsigned __int128 *value)
+{
+    char hex[33];
+    if(fscanf(fp," %32[0-9a-f]",hex)!=1 || strlen(hex)!=32)
+        return false;
+    char high[17];
+    memcpy(high, hex, 16);
+    high[16]=0;
+    *value = ((unsigned __int128)strtoull(high, NULL, 16) << 64) | strtoull(hex+16, NULL, 16);
+    return true;
+}
 
-                // RECC implimentation
-                result_type_recc = error_correction_QPC(codeword); 
-
-                Chip_idx=0;
-                while(Chip_idx<CHIP_NUM){
-                    for(int Pin_num=0; Pin_num<CHIP_WIDTH; Pin_num++){                        
-                        Chip_array[Chip_idx][Pin_num*8]=codeword[Chip_idx*32+Pin_num*8];
-                        Chip_array[Chip_idx][Pin_num*8+1]=codeword[Chip_idx*32+Pin_num*8+1];
-                        Chip_array[Chip_idx][Pin_num*8+2]=codeword[Chip_idx*32+Pin_num*8+2];
-                        Chip_array[Chip_idx][Pin_num*8+3]=codeword[Chip_idx*32+Pin_num*8+3];
-                        Chip_array[Chip_idx][Pin_num*8+4]=codeword[Chip_idx*32+Pin_num*8+4];
-                        Chip_array[Chip_idx][Pin_num*8+5]=codeword[Chip_idx*32+Pin_num*8+5];
-                        Chip_array[Chip_idx][Pin_num*8+6]=codeword[Chip_idx*32+Pin_num*8+6];
-                        Chip_array[Chip_idx][Pin_num*8+7]=codeword[Chip_idx*32+Pin_num*8+7];
-                    }
-                    Chip_idx++;
-                }
+bool write_checkpoint(const char *file_name, const Fault_sim_partial *partial)
+{
+    string temp_name = string(file_name) + ".tmp";
+    FILE *fp=fopen(temp_name.c_str(),"w");
+    if(fp==NULL)
+        return false;
+    fprintf(fp,"Fault_sim checkpoint\n");
+    fprintf(fp,"Config : %s %s %s\n",partial->OECC.c_str(),partial->FAULT.c_str(),partial->RECC.c_str());
+    fprintf(fp,"Seed : %llu\n",(unsigned long long)partial->seed);
+    fprintf(fp,"Importance sampling bias : %.17g\n",partial->is_bias);
+    fprintf(fp,"Trials : %lld %lld %d\n",partial->first_trial,partial->run_num,partial->finished);
+    fprintf(fp,"Counts : %lld %lld %lld\n",partial->total.CE_cnt,partial->total.DUE_cnt,partial->total.SDC_cnt);
+    fprintf(fp,"Weights :");
+    for(int type=0; type<4; type++){
+        write_u128(fp, partial->total.weight_sum[type]);
+        write_u128(fp, partial->total.weight2_sum[type]);
+    }
+    fprintf(fp,"\n");
+    bool ok = (fflush(fp)==0);
+    ok = (fclose(fp)==0) && ok;
+    return ok && rename(temp_name.c_str(), file_name)==0;
+}
 
-                // SDC check
-                if(result_type_recc==CE || result_type_recc==NE){
-                    int error_check=SDC_check(0, Chip_array, recc_type);
-                    if(error_check){
-                        final_result_1=SDC;
-                    }
-                }
-                // DUE check
-                if(result_type_recc==DUE)
-                    final_result_1=DUE;
-            
+bool read_checkpoint(const char *file_name, Fault_sim_partial *partial)
+{
+    FILE *fp=fopen(file_name,"r");
+    if(fp==NULL)
+        return false;
+    char OECC[32], FAULT[32], RECC[32];
+    unsigned long long seed;
+    memset(&partial->total, 0, sizeof(partial->total));
+    bool ok = fscanf(fp,"Fault_sim checkpoint Config : %31s %31s %31s Seed : %llu Importance sampling bias : %lf",OECC,FAULT,RECC,&seed,&partial->is_bias)==5
+           && fscanf(fp," Trials : %lld %lld %d",&partial->first_trial,&partial->run_num,&partial->finished)==3
+           && fscanf(fp," Counts : %lld %lld %lld",&partial->total.CE_cnt,&partial->total.DUE_cnt,&partial->total.SDC_cnt)==3
+           && fscanf(fp," Weights :")==0;
+    for(int type=0; type<4 && ok; type++)
+        ok = read_u128(fp, &partial->total.weight_sum[type]) && read_u128(fp, &partial->total.weight2_sum[type]);
+    fclose(fp);
+    if(!ok)
+        return false;
+    partial->OECC=OECC;
+    partial->FAULT=FAULT;
+    partial->RECC=RECC;
+    partial->seed=seed;
+    return true;
+}
 
-                // 2nd memory transfer block
-                Chip_idx=0;
-                while(Chip_idx<CHIP_NUM){
-                    for(int Pin_num=0; Pin_num<CHIP_WIDTH; Pin_num++){
-                        codeword[Chip_idx*32+Pin_num*8]=Chip_array[Chip_idx][32+Pin_num*8];
-                        codeword[Chip_idx*32+Pin_num*8+1]=Chip_array[Chip_idx][32+Pin_num*8+1];
-                        codeword[Chip_idx*32+Pin_num*8+2]=Chip_array[Chip_idx][32+Pin_num*8+2];
-                        codeword[Chip_idx*32+Pin_num*8+3]=Chip_array[Chip_idx][32+Pin_num*8+3];
-                        codeword[Chip_idx*32+Pin_num*8+4]=Chip_array[Chip_idx][32+Pin_num*8+4];
-                        codeword[Chip_idx*32+Pin_num*8+5]=Chip_array[Chip_idx][32+Pin_num*8+5];
-                        codeword[Chip_idx*32+Pin_num*8+6]=Chip_array[Chip_idx][32+Pin_num*8+6];
-                        codeword[Chip_idx*32+Pin_num*8+7]=Chip_array[Chip_idx][32+Pin_num*8+7];
-                    }
-                    Chip_idx++;
-                }
 
-                // RECC implimentation
-                result_type_recc = error_correction_QPC(codeword); 
-
-                Chip_idx=0;
-                while(Chip_idx<CHIP_NUM){
-                    for(int Pin_num=0; Pin_num<CHIP_WIDTH; Pin_num++){                        
-                        Chip_array[Chip_idx][32+Pin_num*8]=codeword[Chip_idx*32+Pin_num*8];
-                        Chip_array[Chip_idx][32+Pin_num*8+1]=codeword[Chip_idx*32+Pin_num*8+1];
-                        Chip_array[Chip_idx][32+Pin_num*8+2]=codeword[Chip_idx*32+Pin_num*8+2];
-                        Chip_array[Chip_idx][32+Pin_num*8+3]=codeword[Chip_idx*32+Pin_num*8+3];
-                        Chip_array[Chip_idx][32+Pin_num*8+4]=codeword[Chip_idx*32+Pin_num*8+4];
-                        Chip_array[Chip_idx][32+Pin_num*8+5]=codeword[Chip_idx*32+Pin_num*8+5];
-                        Chip_array[Chip_idx][32+Pin_num*8+6]=codeword[Chip_idx*32+Pin_num*8+6];
-                        Chip_array[Chip_idx][32+Pin_num*8+7]=codeword[Chip_idx*32+Pin_num*8+7];
-                    }
-                    Chip_idx++;
-                }
+// result file (.S) of run_num trials
+void write_result_file(FILE *fp3, long long run_num, uint64_t seed, const Fault_sim_result *total, double confidence, double z)
+{
+    long long result_cnt[3]={total->CE_cnt, total->DUE_cnt, total->SDC_cnt};
+    const char *result_name[3]={"CE", "DUE", "SDC"};
+    fprintf(fp3,"\n===============\n");
+    fprintf(fp3,"Runtime : %lld\n",run_num);
+    fprintf(fp3,"Seed : %llu\n",(unsigned long long)seed);
+    if(is_bias>0){ // importance sampling : unbiased weighted estimates
+        fprintf(fp3,"Importance sampling bias : %g\n",is_bias);
+        double rate[3], std_err[3];
+        for(int result=0; result<3; result++)
+            weighted_estimate(total->weight_sum[CE+result], total->weight2_sum[CE+result], run_num, &rate[result], &std_err[result]);
+        for(int result=0; result<3; result++)
+            fprintf(fp3,"%s : %.11f\n",result_name[result],rate[result]);
+        fprintf(fp3,"\n");
+        for(int result=0; result<3; result++){
+            fprintf(fp3,"%s std. error : %.11e (variance %.11e, %lld sampled)\n",result_name[result],std_err[result],std_err[result]*std_err[result],result_cnt[result]);
+            fprintf(fp3,"%s %g%% CI (normal) : [%.11e, %.11e]\n",result_name[result],confidence*100,(rate[result]-z*std_err[result]>0) ? rate[result]-z*std_err[result] : 0.0,rate[result]+z*std_err[result]);
+        }
+    }
+    else{
+        for(int result=0; result<3; result++)
+            fprintf(fp3,"%s : %.11f\n",result_name[result],(double)result_cnt[result]/(double)run_num);
+        fprintf(fp3,"\n");
+        for(int result=0; result<3; result++){
+            double wilson_lower, wilson_upper, cp_lower, cp_upper;
+            wilson_interval(result_cnt[result], run_num, z, &wilson_lower, &wilson_upper);
+            clopper_pearson_interval(result_cnt[result], run_num, confidence, &cp_lower, &cp_upper);
+            fprintf(fp3,"%s %g%% CI (Wilson) : [%.11e, %.11e]\n",result_name[result],confidence*100,wilson_lower,wilson_upper);
+            fprintf(fp3,"%s %g%% CI (Clopper-Pearson) : [%.11e, %.11e]\n",result_name[result],confidence*100,cp_lower,cp_upper);
+        }
+    }
+    fprintf(fp3,"\n===============\n");
+    fflush(fp3);
+    return;
+}
 
-                // SDC check
-                if(result_type_recc==CE || result_type_recc==NE){
-                    int error_check=SDC_check(1, Chip_array, recc_type);
-                    if(error_check){
-                        final_result_2=SDC;
-                    }
-                }
-                // DUE check
-                if(result_type_recc==DUE)
-                    final_result_2=DUE;
 
-                // final result update
-                final_result = (final_result_1 > final_result_2) ? final_result_1 : final_result_2;
+// merge mode : ./Fault_sim_start --merge [--confidence C] <output file (.S)> <checkpoint files>
+// the partial results must come from the same configuration, seed and bias and cover disjoint trial ranges
+int merge_main(int argc, char* argv[])
+{
+    double confidence=CONFIDENCE;
+    int arg=2;
+    if(arg+1<argc && strcmp(argv[arg],"--confidence")==0){
+        confidence=atof(argv[arg+1]);
+        arg+=2;
+    }
+    if(argc-arg<2){
+        fprintf(stderr,"usage : %s --merge [--confidence C] <output file (.S)> <checkpoint files>\n",argv[0]);
+        return 1;
+    }
+    const char *Result_file_name=argv[arg++];
 
-                break;
+    vector<Fault_sim_partial> partials(argc-arg);
+    for(size_t index=0; index<partials.size(); index++){
+        if(!read_checkpoint(argv[arg+index], &partials[index])){
+            fprintf(stderr,"cannot read checkpoint %s\n",argv[arg+index]);
+            return 1;
+        }
+        const Fault_sim_partial &partial=partials[index], &first=partials[0];
+        if(partial.OECC!=first.OECC || partial.FAULT!=first.FAULT || partial.RECC!=first.RECC || partial.seed!=first.seed || partial.is_bias!=first.is_bias){
+            fprintf(stderr,"%s : configuration, seed or bias differs from %s\n",argv[arg+index],argv[arg]);
+            return 1;
+        }
+        if(!partial.finished)
+            fprintf(stderr,"warning : %s is not finished (%lld trials so far)\n",argv[arg+index],partial.run_num);
+    }
 
- /*------------------------------------------------------------------
-                        AMD Case
--------------------------------------------------------------------*/
+    // disjoint trial ranges (sorted by first trial)
+    vector<pair<long long, long long> > ranges;
+    for(size_t index=0; index<partials.size(); index++)
+        ranges.push_back(make_pair(partials[index].first_trial, partials[index].first_trial+partials[index].run_num));
+    sort(ranges.begin(), ranges.end());
+    for(size_t index=1; index<ranges.size(); index++){
+        if(ranges[index].first<ranges[index-1].second){
+            fprintf(stderr,"overlapping trial ranges : [%lld, %lld) and [%lld, %lld)\n",ranges[index-1].first,ranges[index-1].second,ranges[index].first,ranges[index].second);
+            return 1;
+        }
+    }
 
-            case AMDCHIPKILL:
-                // 1st memory transfer block
-                for(int BL=0; BL<16; BL+=2){ // BL (Burst Length)<16 
-                    unsigned int codeword_AMD[AMDCHIPKILL_CW_LEN];
-                    Chip_idx=0;
-                    while(Chip_idx<CHIP_NUM){
-                        codeword_AMD[Chip_idx*8]=Chip_array[Chip_idx][BL*CHIP_WIDTH];
-                        codeword_AMD[Chip_idx*8+1]=Chip_array[Chip_idx][BL*CHIP_WIDTH+1];
-                        codeword_AMD[Chip_idx*8+2]=Chip_array[Chip_idx][BL*CHIP_WIDTH+2];
-                        codeword_AMD[Chip_idx*8+3]=Chip_array[Chip_idx][BL*CHIP_WIDTH+3];
-                        codeword_AMD[Chip_idx*8+4]=Chip_array[Chip_idx][BL*CHIP_WIDTH+4];
-                        codeword_AMD[Chip_idx*8+5]=Chip_array[Chip_idx][BL*CHIP_WIDTH+5];
-                        codeword_AMD[Chip_idx*8+6]=Chip_array[Chip_idx][BL*CHIP_WIDTH+6];
-                        codeword_AMD[Chip_idx*8+7]=Chip_array[Chip_idx][BL*CHIP_WIDTH+7];
-                        Chip_idx++;
-                    }
+    Fault_sim_result total;
+    memset(&total, 0, sizeof(total));
+    long long run_num=0;
+    for(size_t index=0; index<partials.size(); index++){
+        add_result(&total, &partials[index].total);
+        run_num += partials[index].run_num;
+    }
+    if(run_num==0){
+        fprintf(stderr,"no trials to merge\n");
+        return 1;
+    }
 
-                    // RECC implimentation
-                    result_type_recc = error_correction_AMDCHIPKILL(codeword_AMD, error_chip_position); 
-
-                    Chip_idx=0;
-                    while(Chip_idx<CHIP_NUM){
-                        Chip_array[Chip_idx][BL*CHIP_WIDTH]=codeword_AMD[Chip_idx*8];
-                        Chip_array[Chip_idx][BL*CHIP_WIDTH+1]=codeword_AMD[Chip_idx*8+1];
-                        Chip_array[Chip_idx][BL*CHIP_WIDTH+2]=codeword_AMD[Chip_idx*8+2];
-                        Chip_array[Chip_idx][BL*CHIP_WIDTH+3]=codeword_AMD[Chip_idx*8+3];
-                        Chip_array[Chip_idx][BL*CHIP_WIDTH+4]=codeword_AMD[Chip_idx*8+4];
-                        Chip_array[Chip_idx][BL*CHIP_WIDTH+5]=codeword_AMD[Chip_idx*8+5];
-                        Chip_array[Chip_idx][BL*CHIP_WIDTH+6]=codeword_AMD[Chip_idx*8+6];
-                        Chip_array[Chip_idx][BL*CHIP_WIDTH+7]=codeword_AMD[Chip_idx*8+7];
-                        Chip_idx++;
-                    }
+    FILE *fp3=fopen(Result_file_name,"w");
+    if(fp3==NULL){
+        fprintf(stderr,"cannot open %s\n",Result_file_name);
+        return 1;
+    }
+    is_bias=partials[0].is_bias;
+    write_result_file(fp3, run_num, partials[0].seed, &total, confidence, normal_quantile(confidence));
+    fclose(fp3);
+    return 0;
+}
 
-                    // SDC check
-                    if(result_type_recc==CE || result_type_recc==NE){
-                        int error_check=SDC_check(BL, Chip_array, recc_type);
-                        if(error_check){
-                            result_type_recc=SDC;
-                        }
-                    }
-                    // DUE check
-                    if(result_type_recc==DUE || final_result_1==DUE)
-                        final_result_1=DUE;
-                    else{ 
-                        final_result_1 = (final_result_1>result_type_recc) ? final_result_1 : result_type_recc;
-                    }
 
-                    if(CONSERVATIVE_MODE)
-                        isConservative = (error_chip_position.size()>1) ? 1 : isConservative;                    
-                }
+#ifndef FAULT_SIM_BENCH // Fault_sim_bench.cpp includes this file with its own main
+int main(int argc, char* argv[])
+{
+    // sweep mode : ./Fault_sim_start --sweep <oecc-list> <fault-list> <recc-list> [options] [output file]
+    if(argc>1 && strcmp(argv[1],"--sweep")==0)
+        return sweep_main(argc, argv);
+    // merge mode : ./Fault_sim_start --merge <output file> <checkpoint files>
+    if(argc>1 && strcmp(argv[1],"--merge")==0)
+        return merge_main(argc, argv);
+    // lifetime mode : ./Fault_sim_start --lifetime <oecc-list> <recc-list> [options] [output file]
+    if(argc>1 && strcmp(argv[1],"--lifetime")==0)
+        return lifetime_main(argc, argv);
 
-                if(final_result_1==NE || final_result_1==CE){
-                    final_result_1 = (isConservative) ? DUE : CE;
-                }
-                
-                // final result update
-                final_result = final_result_1;
-                break;
 
-            case RECC_OFF:{
-                int error_check;
-                int BL=0; // trash value
-                error_check = SDC_check(BL, Chip_array, recc_type);
-                final_result = (error_check>0) ? SDC : CE;
-                break;
-            }
-            default:
-                break;
-        }
+    // 2. name of output files
+    string OECC="X", RECC="X", FAULT="X"; 
+    int oecc_type, recc_type, fault_type; // => on-die ECC, Rank-level ECC, fault_type 
+    oecc_recc_fault_type_assignment(OECC, FAULT, RECC, &oecc_type, &fault_type, &recc_type, atoi(argv[1]), atoi(argv[2]), atoi(argv[3]));
+    
+    string Result_file_name = RECC + "_" + FAULT + ".S";
+    Fault_sim_options opt;
+    init_sim_options(&opt);
+    for(int arg=4; arg<argc; arg++){
+        int used=parse_sim_option(argc, argv, arg, &opt);
+        if(used>0)
+            arg+=used-1;
+        else // set output directory
+            Result_file_name = string(argv[arg]) + "/" + Result_file_name;
+    }
+    FILE *fp3=fopen(Result_file_name.c_str(),"w"); 
 
-        // 4-5. CE/DUE/SDC check
 
-        CE_cnt   += (final_result==CE)  ? 1 : 0;
-        DUE_cnt  += (final_result==DUE) ? 1 : 0;
-        SDC_cnt  += (final_result==SDC) ? 1 : 0;
+    // 3. iteration
+    finalize_sim_options(&opt);
+    uint64_t seed=opt.seed;
+    double confidence=opt.confidence, z=opt.z;
+
+    if(opt.exhaustive && !exhaustive_supported(fault_type))
+        fprintf(stderr,"warning : --exhaustive does not support %s %s %s, Monte Carlo sampling is used instead\n",OECC.c_str(),FAULT.c_str(),RECC.c_str());
+    if(opt.exhaustive && exhaustive_supported(fault_type)){ // exact fractions, no intervals
+        double exact[3];
+        long long decode_num=0;
+        chrono::steady_clock::time_point start=chrono::steady_clock::now();
+        run_exhaustive(opt.thread_num, oecc_type, fault_type, recc_type, exact, &decode_num);
+        fprintf(fp3,"\n===============\n");
+        if(fault_type==SCE)
+            fprintf(fp3,"Exhaustive : %lld strata (chip x nonzero symbols after OECC) of 2^%d patterns per chip\n",decode_num,(recc_type==OOC) ? OOC_OECC_CW_LEN : OECC_CW_LEN);
+        else
+            fprintf(fp3,"Exhaustive : %lld fault instances\n",decode_num);
+        fprintf(fp3,"CE : %.11f\n",exact[0]);
+        fprintf(fp3,"DUE : %.11f\n",exact[1]);
+        fprintf(fp3,"SDC : %.11f\n",exact[2]);
+        fprintf(fp3,"\n===============\n");
+        fclose(fp3);
+        stats_report((fault_type==SCE) ? "strata" : "fault instances", decode_num, chrono::duration<double>(chrono::steady_clock::now()-start).count());
+        return 0;
+    }
+
+    // convergence is only checked every check_interval trials, so the stopping point depends on the seed only
+    // (--shard : trials [first_trial, first_trial+shard_run_num) of the --runs trials)
+    long long first_trial = opt.max_run_num*opt.shard_id/opt.shard_num;
+    long long shard_run_num = opt.max_run_num*(opt.shard_id+1)/opt.shard_num - first_trial;
+    Fault_sim_partial partial;
+    partial.OECC=OECC;
+    partial.FAULT=FAULT;
+    partial.RECC=RECC;
+    partial.seed=seed;
+    partial.is_bias=is_bias;
+    partial.first_trial=first_trial;
+    partial.run_num=0;
+    partial.finished=0;
+    memset(&partial.total, 0, sizeof(partial.total));
+    if(opt.checkpoint){ // resume
+        Fault_sim_partial saved;
+        if(read_checkpoint(opt.checkpoint, &saved)){
+            if(saved.OECC!=OECC || saved.FAULT!=FAULT || saved.RECC!=RECC || saved.seed!=seed || saved.is_bias!=is_bias || saved.first_trial!=first_trial){
+                fprintf(stderr,"%s : checkpoint of another run (configuration, seed, bias 'or' shard)\n",opt.checkpoint);
+                fclose(fp3);
+                return 1;
+            }
+            partial=saved;
+        }
+    }
+    chrono::steady_clock::time_point start=chrono::steady_clock::now();
+    long long resumed_num=partial.run_num;
+    while(!partial.finished && partial.run_num<shard_run_num){
+        long long round_num = (shard_run_num-partial.run_num<opt.check_interval) ? shard_run_num-partial.run_num : opt.check_interval;
+        run_trials(first_trial+partial.run_num, round_num, opt.thread_num, seed, oecc_type, fault_type, recc_type, &partial.total);
+        partial.run_num+=round_num;
+        stats_progress("trials", partial.run_num, shard_run_num, chrono::duration<double>(chrono::steady_clock::now()-start).count());
+
+        partial.finished = (partial.run_num>=shard_run_num) || fault_sim_converged(&partial.total, partial.run_num, &opt);
+        if(opt.checkpoint && !write_checkpoint(opt.checkpoint, &partial))
+            fprintf(stderr,"cannot write checkpoint %s\n",opt.checkpoint);
     }
 
     // final update 
-    fprintf(fp3,"\n===============\n");
-    fprintf(fp3,"Runtime : %d\n",RUN_NUM);
-    fprintf(fp3,"CE : %.11f\n",(double)CE_cnt/(double)RUN_NUM);
-    fprintf(fp3,"DUE : %.11f\n",(double)DUE_cnt/(double)RUN_NUM);
-    fprintf(fp3,"SDC : %.11f\n",(double)SDC_cnt/(double)RUN_NUM);
-    fprintf(fp3,"\n===============\n");
-    fflush(fp3);
+    if(opt.shard_num>1)
+        fprintf(fp3,"Shard : %d/%d (trials %lld ~ %lld)\n",opt.shard_id,opt.shard_num,first_trial,first_trial+partial.run_num-1);
+    if(fault_type==ROWHAMMER) // a trial is a row : CE/DUE/SDC are per row
+        fprintf(fp3,"RowHammer : %d accesses per row, flip probability %g, %s pattern\n",ROW_ACCESS_NUM,rh_flip,rh_pattern_name[rh_pattern]);
+    write_result_file(fp3, partial.run_num, seed, &partial.total, confidence, z);
+    stats_report("trials", partial.run_num-resumed_num, chrono::duration<double>(chrono::steady_clock::now()-start).count());
 
     fclose(fp3);
 
     return 0;
 }
+#endif
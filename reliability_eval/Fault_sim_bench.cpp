@@ -0,0 +1,1171 @@
+// Decoder microbenchmark : ns/decode of the OECC/RECC decoders of Fault_sim.cpp over fixed error corpora
+// (zero-error, single-, double- and beyond-capability patterns), and a check that every pattern is decoded
+// exactly as by the decoders of the original simulator below : same NE/CE/DUE and same corrected bits.
+//   make bench  (or ./Fault_sim_bench [--patterns N] [--repeat R] [--seed S] [output file (.csv/.json)])
+// Exits with 1 on any mismatch. The simulator is included as it is, without its main (FAULT_SIM_BENCH).
+#define FAULT_SIM_BENCH
+#include "Fault_sim.cpp"
+
+#define BENCH_PATTERNS 4096 // patterns per corpus (default of --patterns)
+#define BENCH_REPEAT 64 // timed passes over a corpus (default of --repeat)
+#define BENCH_REFERENCE_REPEAT 1 // max. timed passes of the reference decoders (1000x slower, one pass is enough)
+#define BENCH_SEED 1 // corpus seed (default of --seed)
+#define BENCH_GROUP_PATTERNS 512 // patterns per chip group corpus (at most --patterns, they only check the decodes)
+#ifndef REFERENCE_GF_POLY // input files of the reference tables (set by the Makefile from GF_POLY, OECC_H)
+#define REFERENCE_GF_POLY "inputs/GF_2^8__primitive_polynomial.txt"
+#endif
+#ifndef REFERENCE_OECC_H
+#define REFERENCE_OECC_H "inputs/H_Matrix_OECC.txt"
+#endif
+
+
+/*------------------------------------------------------------------
+                        Reference decoders
+-------------------------------------------------------------------*/
+// The decoders of the original (one int per bit) simulator, copied verbatim together with the helpers
+// and tables they read. Namespace reference shadows the packed/tabulated names of Fault_sim.cpp
+// (index_of, primitive_poly, H_Matrix_OECC, error_correction_*), and the tables are built from the
+// input files at startup (load_reference_tables), so nothing is shared with the optimized decoders.
+namespace reference {
+
+unsigned int H_Matrix_OECC[OECC_REDUN_LEN][OECC_H_CW_LEN]; // 8 x 136
+unsigned int primitive_poly[16][256]={0,}; // primitive polynomial (ex : primitive_poly[4][254] = a^254, primitive_poly[4][255] = 0 (prim_num=4, primitive_poly = x^8+x^6+x^4+x^3+x^2+x^1+1))
+
+
+unsigned int getAbit(unsigned short x, int n) { 
+  return (x & (1 << n)) >> n;
+}
+
+
+unsigned int conversion_to_int_format(char *str_read, int m)
+{
+    unsigned int primitive_value=0;
+    if(strstr(str_read,"^7")!=NULL)
+        primitive_value+=int(pow(2,7));
+    if(strstr(str_read,"^6")!=NULL)
+        primitive_value+=int(pow(2,6));
+    if(strstr(str_read,"^5")!=NULL)
+        primitive_value+=int(pow(2,5));
+    if(strstr(str_read,"^4")!=NULL)
+        primitive_value+=int(pow(2,4));
+    if(strstr(str_read,"^3")!=NULL)
+        primitive_value+=int(pow(2,3));
+    if(strstr(str_read,"^2")!=NULL)
+        primitive_value+=int(pow(2,2));
+    if(strstr(str_read,"^1+")!=NULL) 
+        primitive_value+=int(pow(2,1));
+    if(strstr(str_read,"+1")!=NULL)
+        primitive_value+=int(pow(2,0));
+    
+
+    return primitive_value;
+}
+
+
+// primitive polynomial table 
+void generate_primitive_poly(unsigned int prim_value, int m, int prim_num)
+{
+    unsigned int value = 0x1; // start value (0000 0001)
+    int total_count = int(pow(2,m));
+    int count=0;
+    while (count<total_count-1){ // count : 0~254
+        primitive_poly[prim_num][count]=value;
+        if(value>=0x80){ 
+            value=value<<(32-m+1);
+            value=value>>(32-m);
+
+            value=value^prim_value;
+        }
+        else 
+            value=value<<1;
+        
+        count++;
+    }
+
+    return;
+}
+
+
+
+unsigned int index_of(unsigned int value){
+    unsigned int p;
+    if (value == 0){
+        return -1;
+    }
+    for(int prim_exponent=0; prim_exponent<255; prim_exponent++){
+        if(value==primitive_poly[0][prim_exponent])
+            p=prim_exponent;
+        }
+    return p;   
+}
+
+
+// OECC 1bit correction
+void error_correction_oecc(unsigned int *codeword)
+{
+    unsigned int Syndromes[OECC_REDUN_LEN]; // 8 x 1
+    
+    // Syndromes = H * C^T
+    for(int row=0; row<OECC_REDUN_LEN; row++){
+        unsigned int row_value=0;
+        for(int column=0; column<OECC_CW_LEN; column++)
+            row_value=row_value^(H_Matrix_OECC[row][column] * codeword[column]);
+        Syndromes[row]=row_value;
+    }
+
+    // error correction (Check Syndromes)
+    int cnt=0;
+    for(int error_pos=0; error_pos<OECC_CW_LEN; error_pos++){
+        cnt=0;
+        for(int row=0; row<OECC_REDUN_LEN; row++){
+            if(Syndromes[row]==H_Matrix_OECC[row][error_pos])
+                cnt++;
+            else
+                break;
+        }
+        // 1-bit error -> error correction 
+        if(cnt==OECC_REDUN_LEN){
+            codeword[error_pos]^=1;
+            return;
+        }
+    }
+
+    return;
+}
+
+
+/*------------------------------------------------------------------
+                        OOC Correction
+-------------------------------------------------------------------*/
+int error_correction_OOC(unsigned int *codeword_OOC)
+{
+   int i,j,u,q ;
+
+   int elp[nn-OOC_kk+2][nn-OOC_kk], d[nn-OOC_kk+2], l[nn-OOC_kk+2], u_lu[nn-OOC_kk+2], s[nn-OOC_kk+1] ; 
+   int count=0, syn_error=0, root[OOC_tt], loc[OOC_tt], z[OOC_tt+1], err[nn], reg[OOC_tt+1]; 
+   unsigned int recd[OOC_nn_short] = {0};
+
+  for (i=1; i<=2*OOC_tt; i++){
+    s[i] = 0;
+
+    for(int symbol_index=0; symbol_index<OOC_CW_SYMBOL_NUM; symbol_index++){ 
+        unsigned exponent=255; 
+        unsigned symbol_value=0; 
+
+        for(int symbol_value_index=0; symbol_value_index<SYMBOL_SIZE; symbol_value_index++){ 
+            symbol_value^=(codeword_OOC[symbol_index*8+symbol_value_index] << (SYMBOL_SIZE-1-symbol_value_index)); 
+        }
+
+        recd[symbol_index] = symbol_value;
+
+        for(int prim_exponent=0; prim_exponent<255; prim_exponent++){
+            if(symbol_value==primitive_poly[0][prim_exponent]){
+                exponent=prim_exponent;
+                break;
+            }
+        }
+        
+        if(exponent!=255)
+            s[i]^=primitive_poly[0][(exponent+i*symbol_index)%255];
+    }
+
+    if (s[i]!=0){
+        syn_error=1;
+    }    
+    s[i] = index_of(s[i]);
+  }
+
+ // Syndrome != 0 -> CE 'or' DUE 'or' SDC
+  if (syn_error)       /* if errors, try and correct */
+  {
+/* initialise table entries */
+      d[0] = 0 ;           /* index form */
+      d[1] = s[1] ;        /* index form */
+      elp[0][0] = 0 ;      /* index form */
+      elp[1][0] = 1 ;      /* polynomial form */
+      for (i=1; i<nn-OOC_kk; i++)
+        { elp[0][i] = -1 ;   /* index form */
+          elp[1][i] = 0 ;   /* polynomial form */
+        }
+      l[0] = 0 ;     
+      l[1] = 0 ;     
+      u_lu[0] = -1 ; /* index form */
+      u_lu[1] = 0 ;  /* index form */
+      u = 0 ; //step
+
+      do
+      {
+        u++ ;
+        if (d[u]==-1)  // s[i] == 0
+          { l[u+1] = l[u];
+            for (i=0; i<=l[u]; i++)
+             {  elp[u+1][i] = elp[u][i] ;
+                elp[u][i] = index_of(elp[u][i]) ;
+             }
+          }
+        else
+/* search for words with greatest u_lu[q] for which d[q]!=0 */
+          { q = u-1 ;
+            while ((d[q]==-1) && (q>0)) q-- ;
+/* have found first non-zero d[q]  */
+            if (q>0)
+             { j=q ;
+               do
+               { j-- ;
+                 if ((d[j]!=-1) && (u_lu[q]<u_lu[j]))
+                   q = j ;
+               }while (j>0) ;
+             }
+
+/* have now found q such that d[u]!=0 and u_lu[q] is maximum */
+/* store degree of new elp polynomial */
+            if (l[u]>l[q]+u-q)  l[u+1] = l[u] ;
+            else  l[u+1] = l[q]+u-q ;
+
+/* form new elp(x) */
+            for (i=0; i<nn-OOC_kk; i++)    elp[u+1][i] = 0 ;
+            for (i=0; i<=l[q]; i++)
+              if (elp[q][i]!=-1)
+                elp[u+1][i+u-q] = primitive_poly[0][(d[u]+nn-d[q]+elp[q][i])%nn] ;
+            for (i=0; i<=l[u]; i++)
+              { elp[u+1][i] ^= elp[u][i] ;
+                elp[u][i] = index_of(elp[u][i]) ;  /*convert old elp value to index*/
+              }
+          }
+        u_lu[u+1] = u-l[u+1] ;
+
+/* form (u+1)th discrepancy */
+        if (u<nn-OOC_kk)    /* no discrepancy computed on last iteration */
+          {
+            if (s[u+1]!=-1)
+                   d[u+1] = primitive_poly[0][s[u+1]] ;
+            else
+              d[u+1] = 0 ;
+            for (i=1; i<=l[u+1]; i++)
+              if ((s[u+1-i]!=-1) && (elp[u+1][i]!=0))
+                d[u+1] ^= primitive_poly[0][(s[u+1-i]+index_of(elp[u+1][i]))%nn] ;
+            d[u+1] = index_of(d[u+1]) ;    /* put d[u+1] into index form */
+          }
+      } while ((u<nn-OOC_kk) && (l[u+1]<=OOC_tt)) ;
+
+      u++ ;
+
+      ////////////////////////////////////////////////////
+      // error correction start!!!!!!!!!!!!!!!!!!!!!!!!!
+      ////////////////////////////////////////////////////
+
+      // CE 'or' SDC cases
+      if (l[u]<=OOC_tt)         /* can correct error */
+      {
+/* put elp into index form */
+         for (i=0; i<=l[u]; i++)   elp[u][i] = index_of(elp[u][i]) ;
+
+/* find roots of the error location polynomial -> finding error location */
+        for (i=1; i<=l[u]; i++)
+          reg[i] = elp[u][i];
+        
+        count = 0;
+        for (i=1; i<=nn; i++){  
+          q = 1 ;
+          for (j=1; j<=l[u]; j++)
+            if (reg[j]!=-1){ 
+              reg[j] = (reg[j]+j)%nn;
+              q ^= primitive_poly[0][reg[j]];
+            }
+          if (!q) {        /* store root and error location number indices */
+            root[count] = i;
+            loc[count] = nn-i; // -> error location
+            count++;
+          }
+        }
+        
+        int CE_cases=1;
+        //printf("error location check! (shortened RS code!)\n");
+        for(int index=0; index<count; index++){
+          if(loc[index]>=OOC_nn_short) // except for zero-padding part!!
+            CE_cases=0;
+        }
+        
+        if (l[u]>4){
+            int reference_value = loc[0] / 4;
+            for (int index = 0; index < count; index++) {
+                int divided_value = loc[index] / 4;             
+                
+                if ((divided_value != reference_value) && ((divided_value + 10) != reference_value)) {
+                    CE_cases = 0;
+                }
+            }
+        }
+
+         // CE 'or' SDC cases
+         if (count==l[u] && CE_cases==1){    /* no. roots = degree of elp hence <= tt errors*/
+          //printf("CE 'or' SDC cases\n");
+          //printf("count : %d\n",count);
+/* form polynomial z(x) */
+          for (i=1; i<=l[u]; i++){        /* Z[0] = 1 always - do not need */
+            if ((s[i]!=-1) && (elp[u][i]!=-1))
+              z[i] = primitive_poly[0][s[i]] ^ primitive_poly[0][elp[u][i]];
+            else if ((s[i]!=-1) && (elp[u][i]==-1))
+              z[i] = primitive_poly[0][s[i]] ;
+            else if ((s[i]==-1) && (elp[u][i]!=-1))
+              z[i] = primitive_poly[0][elp[u][i]] ;
+            else
+              z[i] = 0 ;
+            for (j=1; j<i; j++){
+              if ((s[j]!=-1) && (elp[u][i-j]!=-1))
+                z[i] ^= primitive_poly[0][(elp[u][i-j] + s[j])%nn];
+            }
+            z[i] = index_of(z[i]);         /* put into index form */
+          }
+
+  /* evaluate errors at locations given by error location numbers loc[i] */
+          for (i=0; i<nn; i++){ 
+            err[i] = 0;
+          }
+
+          for (i=0; i<l[u]; i++){    /* compute numerator of error term first */
+            err[loc[i]] = 1;       /* accounts for z[0] */
+            for (j=1; j<=l[u]; j++){
+              if (z[j]!=-1)
+                err[loc[i]] ^= primitive_poly[0][(z[j]+j*root[i])%nn];
+            }
+            if (err[loc[i]]!=0){
+              err[loc[i]] = index_of(err[loc[i]]);
+                q = 0;     /* form denominator of error term */
+                for (j=0; j<l[u]; j++){
+                  if (j!=i)
+                    q += index_of(1^primitive_poly[0][(loc[j]+root[i])%nn]);
+                }
+                q = q % nn;
+                err[loc[i]] = primitive_poly[0][(err[loc[i]]-q+nn)%nn];
+                recd[loc[i]] ^= err[loc[i]];  /*recd[i] must be in polynomial form */   
+            }
+          }
+
+            for (int symbol_index=0; symbol_index<80; symbol_index++) {
+                if (recd[symbol_index] == 0)
+                    for (int symbol_value_index=0; symbol_value_index<8; symbol_value_index++){
+                        codeword_OOC[symbol_index*8+symbol_value_index] = 0;
+                    }
+            }
+
+          return CE;
+          /*
+          printf("err (error values) : ");
+          for(int index=0; index<nn; index++)
+            printf("%d ",err[index]);
+          printf("\n");
+          */
+        }
+        // DUE cases
+        else{    /* no. roots != degree of elp => >tt errors and cannot solve */
+          //printf("DUE cases!!!\n");
+
+          return DUE;
+        }
+      }
+    // DUE cases
+     else{         /* elp has degree has degree >tt hence cannot solve */
+       //printf("DUE cases!\n");
+       return DUE;
+     }
+  }
+  // NE 'or' SDC cases
+  else{       /* no non-zero syndromes => no errors: output received codeword */
+    //printf("NE 'or' SDC cases!\n");
+    return NE;
+  }
+}
+
+
+/*------------------------------------------------------------------
+                        QPC Correction
+-------------------------------------------------------------------*/
+int error_correction_QPC(unsigned int *codeword)
+{
+   int i,j,u,q;
+
+   int elp[nn-QPC_kk+2][nn-QPC_kk], d[nn-QPC_kk+2], l[nn-QPC_kk+2], u_lu[nn-QPC_kk+2], s[nn-QPC_kk+1] ; 
+   int count=0, syn_error=0, root[QPC_tt], loc[QPC_tt], z[QPC_tt+1], err[nn], reg[QPC_tt+1]; 
+   unsigned int recd[QPC_nn_short] = {0};
+
+  for (i=1; i<=2*QPC_tt; i++){
+    s[i] = 0;
+
+    for(int symbol_index=0; symbol_index<QPC_CW_SYMBOL_NUM; symbol_index++){ // 0~39
+        unsigned exponent=255;
+        unsigned symbol_value=0; // 0000_0000 ~ 1111_1111
+
+        for(int symbol_value_index=0; symbol_value_index<SYMBOL_SIZE; symbol_value_index++){ // 8-bit symbol
+            symbol_value^=(codeword[symbol_index*8+symbol_value_index] << (SYMBOL_SIZE-1-symbol_value_index)); // <<7, <<6, ... <<0
+        }
+
+        recd[symbol_index] = symbol_value;
+
+        for(int prim_exponent=0; prim_exponent<255; prim_exponent++){
+            if(symbol_value==primitive_poly[0][prim_exponent]){
+                exponent=prim_exponent;
+                break;
+            }
+        }
+        
+        if(exponent!=255) // s[i] = (a^exponent0) ^ (a^[exponent1+i*1]) ^ (a^[exponent2+i*2]) ... ^ (a^[exponent39+i*39])
+            s[i]^=primitive_poly[0][(exponent+i*symbol_index)%255];
+    }
+
+    if (s[i]!=0)  syn_error=1;    
+    s[i] = index_of(s[i]);
+  }
+
+ // Syndrome != 0 -> CE 'or' DUE 'or' SDC
+  if (syn_error)       /* if errors, try and correct */
+  {
+/* initialise table entries */
+      d[0] = 0 ;           /* index form */
+      d[1] = s[1] ;        /* index form */
+      elp[0][0] = 0 ;      /* index form */
+      elp[1][0] = 1 ;      /* polynomial form */
+      for (i=1; i<nn-QPC_kk; i++)
+        { elp[0][i] = -1 ;   /* index form */
+          elp[1][i] = 0 ;   /* polynomial form */
+        }
+      l[0] = 0 ;     
+      l[1] = 0 ;     
+      u_lu[0] = -1 ; /* index form */
+      u_lu[1] = 0 ;  /* index form */
+      u = 0 ; //step
+
+      do
+      {
+        u++ ;
+        if (d[u]==-1)  // s[i] == 0
+          { l[u+1] = l[u];
+            for (i=0; i<=l[u]; i++)
+             {  elp[u+1][i] = elp[u][i] ;
+                elp[u][i] = index_of(elp[u][i]) ;
+             }
+          }
+        else
+/* search for words with greatest u_lu[q] for which d[q]!=0 */
+          { q = u-1 ;
+            while ((d[q]==-1) && (q>0)) q-- ;
+/* have found first non-zero d[q]  */
+            if (q>0)
+             { j=q ;
+               do
+               { j-- ;
+                 if ((d[j]!=-1) && (u_lu[q]<u_lu[j]))
+                   q = j ;
+               }while (j>0) ;
+             }
+
+/* have now found q such that d[u]!=0 and u_lu[q] is maximum */
+/* store degree of new elp polynomial */
+            if (l[u]>l[q]+u-q)  l[u+1] = l[u] ;
+            else  l[u+1] = l[q]+u-q ;
+
+/* form new elp(x) */
+            for (i=0; i<nn-QPC_kk; i++)    elp[u+1][i] = 0 ;
+            for (i=0; i<=l[q]; i++)
+              if (elp[q][i]!=-1)
+                elp[u+1][i+u-q] = primitive_poly[0][(d[u]+nn-d[q]+elp[q][i])%nn] ;
+            for (i=0; i<=l[u]; i++)
+              { elp[u+1][i] ^= elp[u][i] ;
+                elp[u][i] = index_of(elp[u][i]) ;  /*convert old elp value to index*/
+              }
+          }
+        u_lu[u+1] = u-l[u+1] ;
+
+/* form (u+1)th discrepancy */
+        if (u<nn-QPC_kk)    /* no discrepancy computed on last iteration */
+          {
+            if (s[u+1]!=-1)
+                   d[u+1] = primitive_poly[0][s[u+1]] ;
+            else
+              d[u+1] = 0 ;
+            for (i=1; i<=l[u+1]; i++)
+              if ((s[u+1-i]!=-1) && (elp[u+1][i]!=0))
+                d[u+1] ^= primitive_poly[0][(s[u+1-i]+index_of(elp[u+1][i]))%nn] ;
+            d[u+1] = index_of(d[u+1]) ;    /* put d[u+1] into index form */
+          }
+      } while ((u<nn-QPC_kk) && (l[u+1]<=QPC_tt)) ;
+
+      u++ ;
+
+      ////////////////////////////////////////////////////
+      // error correction start!!!!!!!!!!!!!!!!!!!!!!!!!
+      ////////////////////////////////////////////////////
+
+      // CE 'or' SDC cases
+      if (l[u]<=QPC_tt)         /* can correct error */
+      {
+/* put elp into index form */
+         for (i=0; i<=l[u]; i++)   elp[u][i] = index_of(elp[u][i]) ;
+
+/* find roots of the error location polynomial -> finding error location */
+        for (i=1; i<=l[u]; i++)
+          reg[i] = elp[u][i];
+        
+        count = 0;
+        for (i=1; i<=nn; i++){  
+          q = 1 ;
+          for (j=1; j<=l[u]; j++)
+            if (reg[j]!=-1){ 
+              reg[j] = (reg[j]+j)%nn;
+              q ^= primitive_poly[0][reg[j]];
+            }
+          if (!q) {        /* store root and error location number indices */
+            root[count] = i;
+            loc[count] = nn-i; // -> error location
+            count++;
+          }
+        }
+        
+        int CE_cases=1;
+        //printf("error location check! (shortened RS code!)\n");
+        for(int index=0; index<count; index++){
+          if(loc[index]>=QPC_nn_short) // except for zero-padding part!!
+            CE_cases=0;
+        }
+        
+        if (l[u]>2){
+            for(int index=0; index<count; index++){
+                if((loc[index] / 4) != (loc[0] / 4)) // except for zero-padding part!!
+                    CE_cases=0;
+            }
+        }
+
+         // CE 'or' SDC cases
+         if (count==l[u] && CE_cases==1){    /* no. roots = degree of elp hence <= tt errors*/
+          //printf("CE 'or' SDC cases\n");
+          //printf("count : %d\n",count);
+/* form polynomial z(x) */
+          for (i=1; i<=l[u]; i++){        /* Z[0] = 1 always - do not need */
+            if ((s[i]!=-1) && (elp[u][i]!=-1))
+              z[i] = primitive_poly[0][s[i]] ^ primitive_poly[0][elp[u][i]];
+            else if ((s[i]!=-1) && (elp[u][i]==-1))
+              z[i] = primitive_poly[0][s[i]] ;
+            else if ((s[i]==-1) && (elp[u][i]!=-1))
+              z[i] = primitive_poly[0][elp[u][i]] ;
+            else
+              z[i] = 0 ;
+            for (j=1; j<i; j++){ 
+              if ((s[j]!=-1) && (elp[u][i-j]!=-1))
+                z[i] ^= primitive_poly[0][(elp[u][i-j] + s[j])%nn];
+            }
+            z[i] = index_of(z[i]);         /* put into index form */
+          }
+
+  /* evaluate errors at locations given by error location numbers loc[i] */
+          for (i=0; i<nn; i++){ 
+            err[i] = 0;
+          }
+
+          for (i=0; i<l[u]; i++){    /* compute numerator of error term first */
+            err[loc[i]] = 1;       /* accounts for z[0] */
+            for (j=1; j<=l[u]; j++){
+              if (z[j]!=-1)
+                err[loc[i]] ^= primitive_poly[0][(z[j]+j*root[i])%nn];
+            }
+            if (err[loc[i]]!=0){
+              err[loc[i]] = index_of(err[loc[i]]);
+                q = 0;     /* form denominator of error term */
+                for (j=0; j<l[u]; j++){
+                  if (j!=i)
+                    q += index_of(1^primitive_poly[0][(loc[j]+root[i])%nn]);
+                }
+                q = q % nn;
+                err[loc[i]] = primitive_poly[0][(err[loc[i]]-q+nn)%nn];
+                recd[loc[i]] ^= err[loc[i]];  /*recd[i] must be in polynomial form */   
+            }
+          }
+
+            for (int symbol_index=0; symbol_index<40; symbol_index++) {
+                if (recd[symbol_index] == 0)
+                    for (int symbol_value_index=0; symbol_value_index<8; symbol_value_index++){
+                        codeword[symbol_index*8+symbol_value_index] = 0;
+                    }
+            }
+
+          return CE;
+          /*
+          printf("err (error values) : ");
+          for(int index=0; index<nn; index++)
+            printf("%d ",err[index]);
+          printf("\n");
+          */
+        }
+        // DUE cases
+        else{    /* no. roots != degree of elp => >tt errors and cannot solve */
+          //printf("DUE cases!!!\n");
+
+          return DUE;
+        }
+      }
+    // DUE cases
+     else{         /* elp has degree has degree >tt hence cannot solve */
+       //printf("DUE cases!\n");
+       return DUE;
+     }
+  }
+  // NE 'or' SDC cases
+  else{       /* no non-zero syndromes => no errors: output received codeword */
+    //printf("NE 'or' SDC cases!\n");
+    return NE;
+  }
+}
+
+
+/*------------------------------------------------------------------
+                        AMD Correction
+-------------------------------------------------------------------*/
+int error_correction_AMDCHIPKILL(unsigned int *codeword, set<int> &error_chip_position)
+{
+    // Syndrome 
+    // S0 = (a^exponent0) ^ (a^exponent1) ^ (a^exponent2) ... ^(a^exponent9)
+    // S1 = (a^exponent0) ^ (a^[exponent1+1]) ^ (a^[exponent2+2]) ... ^ (a^[exponent9+9])
+    // S0 
+    unsigned int S0=0,S1=0;
+    for(int symbol_index=0; symbol_index<AMDCHIPKILL_CW_SYMBOL_NUM; symbol_index++){ // 0~9
+        unsigned exponent=255; 
+        unsigned symbol_value=0; // 0000_0000 ~ 1111_1111
+
+        for(int symbol_value_index=0; symbol_value_index<SYMBOL_SIZE; symbol_value_index++){ // 8-bit symbol
+            symbol_value^=(codeword[symbol_index*8+symbol_value_index] << (SYMBOL_SIZE-1-symbol_value_index)); // <<7, <<6, ... <<0
+        }
+        for(int prim_exponent=0; prim_exponent<255; prim_exponent++){
+            if(symbol_value==primitive_poly[0][prim_exponent]){
+                exponent=prim_exponent;
+                break;
+            }
+        }
+        //printf("symbol_index : %d, symbol_value : %d\n",symbol_index, symbol_value);
+
+        if(exponent!=255) // S0 = (a^exponent0) ^ (a^exponent1) ^ (a^exponent2) ... ^(a^exponent9)
+            S0^=primitive_poly[0][exponent];
+    }
+
+    // S1 
+    for(int symbol_index=0; symbol_index<AMDCHIPKILL_CW_SYMBOL_NUM; symbol_index++){ // 0~9
+        unsigned exponent=255;
+        unsigned symbol_value=0; // 0000_0000 ~ 1111_1111
+        for(int symbol_value_index=0; symbol_value_index<SYMBOL_SIZE; symbol_value_index++){ // 8-bit symbol
+            symbol_value^=(codeword[symbol_index*8+symbol_value_index] << (SYMBOL_SIZE-1-symbol_value_index)); // <<7, <<6, ... <<0
+        }
+        for(int prim_exponent=0; prim_exponent<255; prim_exponent++){
+            if(symbol_value==primitive_poly[0][prim_exponent]){
+                exponent=prim_exponent;
+                break;
+            }
+        }
+        
+        if(exponent!=255) // S1 = (a^exponent0) ^ (a^[exponent1+1]) ^ (a^[exponent2+2]) ... ^ (a^[exponent9+9])
+            S1^=primitive_poly[0][(exponent+symbol_index)%255];
+    }
+
+    // S0 = a^p, S1= a^q (a^0 ~ a^254)
+    unsigned int p,q;
+    for(int prim_exponent=0; prim_exponent<255; prim_exponent++){
+        if(S0==primitive_poly[0][prim_exponent])
+            p=prim_exponent;
+        if(S1==primitive_poly[0][prim_exponent])
+            q=prim_exponent;
+    }
+    //printf("S0 : %d(a^%d), S1 : %d(a^%d)\n",S0,p,S1,q);
+
+    //printf("S0 : %d\n",S0);
+    if(S0==0 && S1==0){ // NE (No Error)
+        return NE;
+    }
+    
+    // CE 'or' DUE
+    // error chip position
+    int error_symbol_position_recc;
+    error_symbol_position_recc=(q+255-p)%255;
+
+    // Table
+    if(0<=error_symbol_position_recc && error_symbol_position_recc < CHIP_NUM){ // CE (error chip location : 0~9)
+        // printf("CE case! error correction start!\n");
+        //error correction
+        for(int symbol_index=0; symbol_index<SYMBOL_SIZE; symbol_index++){ // 0~7
+            codeword[error_symbol_position_recc*SYMBOL_SIZE+symbol_index]^=getAbit(S0, SYMBOL_SIZE-1-symbol_index); // S0 >> 7, S0 >> 6 ... S0 >> 0
+            //Chip_array[error_symbol_position_recc][BL*4+symbol_index]^=getAbit(S0, SYMBOL_SIZE-1-symbol_index); // S0 >> 7, S0 >> 6 ... S0 >> 0
+        }
+        // printf("CE case! error correction done!\n");     
+        error_chip_position.insert(error_symbol_position_recc);
+        return CE;
+    }
+    // Table End!!!!!
+    
+    // DUE
+    return DUE;
+}
+
+
+// primitive_poly and H_Matrix_OECC from the input files as in the original main, except that the polynomial
+// file is read up to its last line and the H matrix with its full OECC_REDUN_LEN x OECC_H_CW_LEN size
+// (false : a file cannot be read)
+bool load_reference_tables()
+{
+    FILE *fp=fopen(REFERENCE_GF_POLY,"r");
+    if(fp==NULL)
+        return false;
+    char str_read[100];
+    int primitive_count=0;
+    while(primitive_count<16 && fgets(str_read,100,fp)!=NULL){
+        generate_primitive_poly(conversion_to_int_format(str_read, 8),8,primitive_count);
+        primitive_count++;
+    }
+    fclose(fp);
+
+    FILE *fp1=fopen(REFERENCE_OECC_H,"r");
+    if(fp1==NULL)
+        return false;
+    for(int row=0; row<OECC_REDUN_LEN; row++){
+        for(int column=0; column<OECC_H_CW_LEN; column++){
+            if(fscanf(fp1,"%u ",&H_Matrix_OECC[row][column])!=1){
+                fclose(fp1);
+                return false;
+            }
+        }
+    }
+    fclose(fp1);
+    return primitive_count>0;
+}
+
+} // namespace reference
+
+
+/*------------------------------------------------------------------
+                        Adapters
+-------------------------------------------------------------------*/
+// Packed chip words <-> the bit arrays of the original decoders, gathered and scattered as in the original main :
+// codeword[chip*width+k] = position first+k of the chip word (AMDCHIPKILL : width 8, QPC/OOC : width 32).
+void unpack_bits(const uint64_t *Chip_array, int chip_num, int first, int width, unsigned int *codeword)
+{
+    for(int chip=0; chip<chip_num; chip++)
+        for(int bit=0; bit<width; bit++)
+            codeword[chip*width+bit] = (Chip_array[chip] & BIT_MASK(first+bit)) ? 1 : 0;
+    return;
+}
+
+void pack_bits(const unsigned int *codeword, int chip_num, int first, int width, uint64_t *Chip_array)
+{
+    for(int chip=0; chip<chip_num; chip++)
+        for(int bit=0; bit<width; bit++)
+            Chip_array[chip] = (Chip_array[chip] & ~BIT_MASK(first+bit)) | ((codeword[chip*width+bit] & 1) ? BIT_MASK(first+bit) : 0);
+    return;
+}
+
+
+// The original AMD decoder reads an uninitialized p (S0=0) or q (S1=0) when exactly one syndrome is zero.
+// Those patterns are a DUE (no correction) since the GF tables were introduced, and are checked against that.
+bool reference_amd_syndrome_undefined(const unsigned int *codeword)
+{
+    unsigned int S0=0, S1=0;
+    for(int symbol_index=0; symbol_index<AMDCHIPKILL_CW_SYMBOL_NUM; symbol_index++){
+        unsigned int symbol_value=0;
+        for(int symbol_value_index=0; symbol_value_index<SYMBOL_SIZE; symbol_value_index++)
+            symbol_value^=(codeword[symbol_index*8+symbol_value_index] << (SYMBOL_SIZE-1-symbol_value_index));
+        if(symbol_value!=0){
+            S0^=symbol_value;
+            S1^=reference::primitive_poly[0][(reference::index_of(symbol_value)+symbol_index)%255];
+        }
+    }
+    return (S0==0) != (S1==0);
+}
+
+
+/*------------------------------------------------------------------
+                        Corpora
+-------------------------------------------------------------------*/
+enum BENCH_DECODER {BENCH_AMD=0, BENCH_QPC=1, BENCH_QPC_BLOCK1=2, BENCH_OOC=3, BENCH_OECC=4, BENCH_OECC_OOC=5, BENCH_DECODER_NUM=6};
+enum BENCH_CORPUS {CORPUS_ZERO=0, CORPUS_SINGLE=1, CORPUS_DOUBLE=2, CORPUS_BEYOND=3,
+                   CORPUS_GROUP_T1=4, CORPUS_GROUP_T=5, CORPUS_CROSS=6, CORPUS_NUM=7};
+
+struct Bench_decoder {
+    const char *name;
+    int unit_num; // symbols (bits for OECC) an error can hit
+    int tt; // correctable units
+    int chip_num; // chips of the packed input
+    int chip_symbols; // QPC/OOC : symbols of a chip in the codeword (Codec::chip_symbols)
+    int group_chips; // QPC/OOC : chip groups of the spread rule (Codec::group_chips), 0 : no chip group corpora
+    int block; // QPC/OOC : codeword (Codec::block_mask(block))
+    int bit_num; // OECC : codeword length (positions 0 ~ bit_num-1)
+};
+
+const Bench_decoder bench_decoder[BENCH_DECODER_NUM]={
+    {"AMDCHIPKILL", AMDCHIPKILL_CW_SYMBOL_NUM, 1, CHIP_NUM, 1, 0, 0, 0}, // one codeword (symbol 0 of the 10 chips)
+    {"QPC", QPC_codec::n_short, QPC_tt, QPC_codec::chip_num, QPC_codec::chip_symbols, QPC_codec::group_chips, 0, 0},
+    {"QPC_block1", QPC_codec::n_short, QPC_tt, QPC_codec::chip_num, QPC_codec::chip_symbols, QPC_codec::group_chips, 1, 0},
+    {"OOC", OOC_codec::n_short, OOC_tt, OOC_codec::chip_num, OOC_codec::chip_symbols, OOC_codec::group_chips, 0, 0},
+    {"OECC", OECC_CW_LEN, 1, 1, 0, 0, 0, OECC_CW_LEN}, // one chip word
+    {"OECC_OOC", OOC_OECC_CW_LEN, 1, 1, 0, 0, 0, OOC_OECC_CW_LEN}, // one OOC chip word, random bits in positions 32~63
+};
+
+// QPC/OOC : first bit position and length of the codeword in every chip word
+int bench_block_offset(int decoder) { return SYMBOL_SIZE*bench_decoder[decoder].chip_symbols*bench_decoder[decoder].block; }
+int bench_block_bits(int decoder) { return SYMBOL_SIZE*bench_decoder[decoder].chip_symbols; }
+const char *corpus_name[CORPUS_NUM]={"zero", "single", "double", "beyond", "group_t-1", "group_t", "cross"};
+
+// errors per pattern : beyond = t+1, at least 3 (for t=1 codes, double already is beyond)
+// chip group corpora (more than spread_tt errors, see error_correction_RS) :
+//   group_t-1, group_t : t-1 and t errors in one chip group (QPC : one chip, OOC : chip pair c/c+10), corrected
+//   cross : t errors over two chip groups, DUE
+int corpus_error_num(int decoder, int corpus)
+{
+    if(corpus==CORPUS_BEYOND)
+        return max(bench_decoder[decoder].tt+1, 3);
+    if(corpus==CORPUS_GROUP_T1)
+        return bench_decoder[decoder].tt-1;
+    if(corpus==CORPUS_GROUP_T || corpus==CORPUS_CROSS)
+        return bench_decoder[decoder].tt;
+    return corpus;
+}
+
+bool corpus_supported(int decoder, int corpus)
+{
+    return corpus<CORPUS_GROUP_T1 || bench_decoder[decoder].group_chips>0;
+}
+
+// symbol 'index' (0 ~ chips of the group x chip_symbols - 1) of chip group 'group'
+int group_unit(int decoder, int group, int index)
+{
+    const Bench_decoder &bench=bench_decoder[decoder];
+    int chip = group + bench.group_chips*(index/bench.chip_symbols);
+    return chip*bench.chip_symbols + index%bench.chip_symbols;
+}
+
+struct Bench_pattern {
+    uint64_t Chip_array[OOC_CHIP_NUM]; // packed, see BIT_MASK (the reference decoders get it through unpack_bits)
+    uint32_t dirty;
+};
+
+
+// error 'value' (a bit for OECC) at 'unit' of the codeword
+void set_bench_error(int decoder, int unit, unsigned int value, Bench_pattern *pattern)
+{
+    switch(decoder){
+        case BENCH_AMD: // symbol 0 of chip 'unit'
+            pattern->Chip_array[unit] |= (uint64_t)value << (OECC_CW_LEN-SYMBOL_SIZE);
+            pattern->dirty |= 1u << unit;
+            break;
+        case BENCH_QPC:
+        case BENCH_QPC_BLOCK1:
+        case BENCH_OOC:{ // symbol 'unit' of the block (see gather_codeword)
+            int chip_symbols=bench_decoder[decoder].chip_symbols;
+            pattern->Chip_array[unit/chip_symbols] |= ((uint64_t)value << (OECC_CW_LEN-SYMBOL_SIZE*(unit%chip_symbols+1))) >> bench_block_offset(decoder);
+            pattern->dirty |= 1u << (unit/chip_symbols);
+            break;
+        }
+        case BENCH_OECC:
+        case BENCH_OECC_OOC:
+            pattern->Chip_array[0] ^= BIT_MASK(unit);
+            pattern->dirty |= 1u;
+            break;
+    }
+    return;
+}
+
+
+// pattern 'index' of a corpus (stream 'index' of the seed) : distinct units, nonzero values
+void generate_bench_pattern(int decoder, int corpus, uint64_t seed, long long index, Bench_pattern *pattern)
+{
+    memset(pattern, 0, sizeof(Bench_pattern));
+    sim_rng.seed(seed + 1000003ULL*(decoder*CORPUS_NUM+corpus), index);
+    if(decoder==BENCH_OECC_OOC){ // nonzero bits outside the codeword, which must not change the decode
+        do{
+            pattern->Chip_array[0] = sim_rand64() & ~OOC_CHIP_MASK;
+        }while(pattern->Chip_array[0]==0);
+        pattern->dirty |= 1u;
+    }
+    int error_num=corpus_error_num(decoder, corpus), unit[RS_tt_MAX+1];
+    int group[2]={0, 0}, first_group_num=error_num; // chip group corpora : errors 0 ~ first_group_num-1 in group[0]
+    int group_unit_num = (bench_decoder[decoder].group_chips>0) ? bench_decoder[decoder].unit_num/bench_decoder[decoder].group_chips : 0;
+    if(corpus>=CORPUS_GROUP_T1){
+        group[0] = sim_rand_bounded(bench_decoder[decoder].group_chips);
+        group[1] = (group[0]+1+sim_rand_bounded(bench_decoder[decoder].group_chips-1)) % bench_decoder[decoder].group_chips;
+        if(corpus==CORPUS_CROSS)
+            first_group_num = 1+sim_rand_bounded(error_num-1);
+    }
+    for(int error=0; error<error_num; error++){
+        bool duplicate;
+        do{
+            if(corpus>=CORPUS_GROUP_T1)
+                unit[error] = group_unit(decoder, group[(error<first_group_num) ? 0 : 1], sim_rand_bounded(group_unit_num));
+            else
+                unit[error] = sim_rand_bounded(bench_decoder[decoder].unit_num);
+            duplicate=false;
+            for(int prev=0; prev<error; prev++)
+                duplicate |= (unit[prev]==unit[error]);
+        }while(duplicate);
+        set_bench_error(decoder, unit[error], 1+sim_rand_bounded(nn), pattern);
+    }
+    return;
+}
+
+
+/*------------------------------------------------------------------
+                        Decoding
+-------------------------------------------------------------------*/
+// optimized decoders, called as in fault_sim_decode (Chip_array, dirty : modified in place) -> NE/CE/DUE
+template<class Codec>
+int bench_decode_RS(uint64_t *Chip_array, uint32_t *dirty, int block)
+{
+    int syndrome[2*Codec::tt+1];
+    unsigned int codeword[Codec::n_short];
+    if(!rs_syndrome_packed<Codec>(Chip_array, *dirty, block, syndrome))
+        return NE;
+    gather_codeword<Codec>(Chip_array, *dirty, block, codeword);
+    int result=error_correction_RS<Codec>(codeword, syndrome);
+    scatter_codeword<Codec>(Chip_array, *dirty, block, codeword);
+    return result;
+}
+
+int bench_decode(int decoder, uint64_t *Chip_array, uint32_t *dirty)
+{
+    switch(decoder){
+        case BENCH_AMD:{
+            uint64_t S0_lanes, S1_lanes;
+            set<int> error_chip_position;
+            amd_syndrome_lanes(Chip_array, *dirty, &S0_lanes, &S1_lanes);
+            return error_correction_AMDCHIPKILL(Chip_array, dirty, 0, get_symbol(S0_lanes, 0), get_symbol(S1_lanes, 0), error_chip_position);
+        }
+        case BENCH_QPC:
+        case BENCH_QPC_BLOCK1:
+            return bench_decode_RS<QPC_codec>(Chip_array, dirty, bench_decoder[decoder].block);
+        case BENCH_OOC:
+            return bench_decode_RS<OOC_codec>(Chip_array, dirty, 0);
+        case BENCH_OECC:
+        case BENCH_OECC_OOC:{ // no decision : CE when a bit is flipped
+            uint64_t word=Chip_array[0];
+            error_correction_oecc(&Chip_array[0], bench_decoder[decoder].bit_num);
+            return (Chip_array[0]!=word) ? CE : NE;
+        }
+    }
+    return NE;
+}
+
+// original decoders on the same packed input (modified in place) -> NE/CE/DUE (*undefined : see reference_amd_syndrome_undefined)
+int bench_decode_reference(int decoder, uint64_t *Chip_array, bool *undefined)
+{
+    unsigned int codeword[OOC_CW_LEN];
+    *undefined=false;
+    switch(decoder){
+        case BENCH_AMD:{
+            unpack_bits(Chip_array, CHIP_NUM, 0, SYMBOL_SIZE, codeword);
+            if(reference_amd_syndrome_undefined(codeword)){
+                *undefined=true;
+                return DUE;
+            }
+            set<int> error_chip_position;
+            int result=reference::error_correction_AMDCHIPKILL(codeword, error_chip_position);
+            pack_bits(codeword, CHIP_NUM, 0, SYMBOL_SIZE, Chip_array);
+            return result;
+        }
+        case BENCH_QPC:
+        case BENCH_QPC_BLOCK1:{
+            unpack_bits(Chip_array, CHIP_NUM, bench_block_offset(decoder), bench_block_bits(decoder), codeword);
+            int result=reference::error_correction_QPC(codeword);
+            pack_bits(codeword, CHIP_NUM, bench_block_offset(decoder), bench_block_bits(decoder), Chip_array);
+            return result;
+        }
+        case BENCH_OOC:{
+            unpack_bits(Chip_array, OOC_CHIP_NUM, 0, bench_block_bits(decoder), codeword);
+            int result=reference::error_correction_OOC(codeword);
+            pack_bits(codeword, OOC_CHIP_NUM, 0, bench_block_bits(decoder), Chip_array);
+            return result;
+        }
+        case BENCH_OECC:
+        case BENCH_OECC_OOC:{ // positions bit_num~63 are not part of the codeword : zero in, not written back
+            int bit_num=bench_decoder[decoder].bit_num;
+            uint64_t word=Chip_array[0];
+            memset(codeword, 0, sizeof(unsigned int)*OECC_CW_LEN);
+            unpack_bits(Chip_array, 1, 0, bit_num, codeword);
+            reference::error_correction_oecc(codeword);
+            pack_bits(codeword, 1, 0, bit_num, Chip_array);
+            return (Chip_array[0]!=word) ? CE : NE;
+        }
+    }
+    return NE;
+}
+
+
+struct Bench_result {
+    long long pattern_num, mismatch_num;
+    long long undefined_num; // AMDCHIPKILL : patterns the original decoder leaves undefined (checked as DUE)
+    long long outcome[3]; // NE, CE, DUE (optimized)
+    double ns_optimized, ns_reference; // per decode
+};
+
+
+// mismatches of the optimized vs. the reference decoder, then both timed over 'repeat' passes (BENCH_REFERENCE_REPEAT at most for the reference)
+// (the timed loops restore the corrupted input before each decode, as a trial does)
+void run_bench(int decoder, int corpus, const vector<Bench_pattern> &patterns, int repeat, Bench_result *result)
+{
+    memset(result, 0, sizeof(Bench_result));
+    result->pattern_num=patterns.size();
+    for(size_t index=0; index<patterns.size(); index++){
+        Bench_pattern work=patterns[index], reference_work=patterns[index];
+        bool undefined;
+        int outcome=bench_decode(decoder, work.Chip_array, &work.dirty);
+        int reference_outcome=bench_decode_reference(decoder, reference_work.Chip_array, &undefined);
+        result->outcome[outcome]++;
+        result->undefined_num += undefined ? 1 : 0;
+        if(outcome!=reference_outcome || memcmp(work.Chip_array, reference_work.Chip_array, sizeof(work.Chip_array))!=0){
+            if(result->mismatch_num==0)
+                fprintf(stderr,"mismatch : %s %s pattern %zu (optimized %d, reference %d)\n",bench_decoder[decoder].name,corpus_name[corpus],index,outcome,reference_outcome);
+            result->mismatch_num++;
+        }
+    }
+
+    volatile int sink=0;
+    chrono::steady_clock::time_point begin=chrono::steady_clock::now();
+    for(int pass=0; pass<repeat; pass++){
+        for(size_t index=0; index<patterns.size(); index++){
+            uint64_t Chip_array[OOC_CHIP_NUM];
+            memcpy(Chip_array, patterns[index].Chip_array, sizeof(Chip_array));
+            uint32_t dirty=patterns[index].dirty;
+            sink += bench_decode(decoder, Chip_array, &dirty);
+        }
+    }
+    chrono::steady_clock::time_point end=chrono::steady_clock::now();
+    result->ns_optimized = chrono::duration<double, nano>(end-begin).count()/((double)repeat*patterns.size());
+
+    int reference_repeat=min(repeat, BENCH_REFERENCE_REPEAT);
+    begin=chrono::steady_clock::now();
+    for(int pass=0; pass<reference_repeat; pass++){
+        for(size_t index=0; index<patterns.size(); index++){
+            uint64_t Chip_array[OOC_CHIP_NUM];
+            bool undefined;
+            memcpy(Chip_array, patterns[index].Chip_array, sizeof(Chip_array));
+            sink += bench_decode_reference(decoder, Chip_array, &undefined);
+        }
+    }
+    end=chrono::steady_clock::now();
+    result->ns_reference = chrono::duration<double, nano>(end-begin).count()/((double)reference_repeat*patterns.size());
+    return;
+}
+
+
+/*------------------------------------------------------------------
+                        Regression cases
+-------------------------------------------------------------------*/
+// fixed chip words with a known decode, checked before the corpora
+struct Bench_regression {
+    const char *name;
+    uint64_t word; // OECC input (packed, see BIT_MASK)
+    int bit_num;
+    uint64_t expected; // corrected word
+};
+
+const Bench_regression bench_regression[]={
+    // OOC chips only use positions 0~31 : bits 32~63 (injected before they were masked) must not reach the syndrome
+    {"OECC bit 5 of an OOC word, bits 32~63 set", BIT_MASK(5) | 0xDEADBEEFULL, OOC_OECC_CW_LEN, 0xDEADBEEFULL},
+};
+
+// -> number of failed cases
+int run_bench_regressions()
+{
+    int failed_num=0;
+    for(size_t index=0; index<sizeof(bench_regression)/sizeof(bench_regression[0]); index++){
+        const Bench_regression &regression=bench_regression[index];
+        uint64_t word=regression.word;
+        error_correction_oecc(&word, regression.bit_num);
+        if(word!=regression.expected){
+            fprintf(stderr,"regression : %s (got %016llx, expected %016llx)\n",regression.name,(unsigned long long)word,(unsigned long long)regression.expected);
+            failed_num++;
+        }
+    }
+    return failed_num;
+}
+
+
+int main(int argc, char* argv[])
+{
+    long long pattern_num=BENCH_PATTERNS;
+    int repeat=BENCH_REPEAT;
+    uint64_t seed=BENCH_SEED;
+    string Result_file_name = "";
+    for(int arg=1; arg<argc; arg++){
+        if(arg+1<argc && strcmp(argv[arg],"--patterns")==0) // --patterns N : patterns per corpus
+            pattern_num = atoll(argv[++arg]);
+        else if(arg+1<argc && strcmp(argv[arg],"--repeat")==0) // --repeat R : timed passes over a corpus
+            repeat = atoi(argv[++arg]);
+        else if(arg+1<argc && strcmp(argv[arg],"--seed")==0) // --seed S : corpus seed
+            seed = strtoull(argv[++arg], NULL, 10);
+        else if(argv[arg][0]!='-')
+            Result_file_name = argv[arg];
+        else{
+            fprintf(stderr,"usage : %s [--patterns N] [--repeat R] [--seed S] [output file (.csv/.json)]\n",argv[0]);
+            return 1;
+        }
+    }
+    if(pattern_num<1 || repeat<1){
+        fprintf(stderr,"--patterns and --repeat must be positive\n");
+        return 1;
+    }
+    if(!reference::load_reference_tables()){
+        fprintf(stderr,"cannot read %s or %s\n",REFERENCE_GF_POLY,REFERENCE_OECC_H);
+        return 1;
+    }
+
+    FILE *fp3=NULL;
+    bool json = Result_file_name.size()>=5 && Result_file_name.compare(Result_file_name.size()-5, 5, ".json")==0;
+    if(Result_file_name!=""){
+        fp3=fopen(Result_file_name.c_str(),"w");
+        if(fp3==NULL){
+            fprintf(stderr,"cannot open %s\n",Result_file_name.c_str());
+            return 1;
+        }
+        fprintf(fp3, json ? "[\n" : "decoder,corpus,errors,patterns,seed,NE,CE,DUE,ns_optimized,ns_reference,speedup,mismatches\n");
+    }
+    printf("%-12s %-9s %6s %9s %9s %9s %13s %13s %8s %10s\n","decoder","corpus","errors","NE","CE","DUE","ns/decode","ref ns/decode","speedup","mismatches");
+
+    long long mismatch_sum=run_bench_regressions(), undefined_sum=0;
+    for(int decoder=0; decoder<BENCH_DECODER_NUM; decoder++){
+        for(int corpus=0; corpus<CORPUS_NUM; corpus++){
+            if(!corpus_supported(decoder, corpus))
+                continue;
+            vector<Bench_pattern> patterns((corpus>=CORPUS_GROUP_T1) ? min(pattern_num, (long long)BENCH_GROUP_PATTERNS) : pattern_num);
+            for(size_t index=0; index<patterns.size(); index++)
+                generate_bench_pattern(decoder, corpus, seed, index, &patterns[index]);
+            Bench_result result;
+            run_bench(decoder, corpus, patterns, repeat, &result);
+            mismatch_sum += result.mismatch_num;
+            undefined_sum += result.undefined_num;
+            if(corpus==CORPUS_CROSS && result.outcome[DUE]!=result.pattern_num){ // every pattern breaks the spread rule
+                fprintf(stderr,"%s cross : %lld pattern(s) not DUE\n",bench_decoder[decoder].name,result.pattern_num-result.outcome[DUE]);
+                mismatch_sum += result.pattern_num-result.outcome[DUE];
+            }
+
+            double speedup = (result.ns_optimized>0) ? result.ns_reference/result.ns_optimized : 0;
+            printf("%-12s %-9s %6d %9lld %9lld %9lld %13.1f %13.1f %7.1fx %10lld\n",bench_decoder[decoder].name,corpus_name[corpus],corpus_error_num(decoder, corpus),
+                result.outcome[NE],result.outcome[CE],result.outcome[DUE],result.ns_optimized,result.ns_reference,speedup,result.mismatch_num);
+            if(fp3==NULL)
+                continue;
+            bool last = (decoder==BENCH_DECODER_NUM-1 && (corpus==CORPUS_NUM-1 || !corpus_supported(decoder, corpus+1)));
+            if(json)
+                fprintf(fp3,"  {\"decoder\": \"%s\", \"corpus\": \"%s\", \"errors\": %d, \"patterns\": %lld, \"seed\": %llu, \"NE\": %lld, \"CE\": %lld, \"DUE\": %lld, \"ns_optimized\": %.3f, \"ns_reference\": %.3f, \"speedup\": %.3f, \"mismatches\": %lld}%s\n",
+                    bench_decoder[decoder].name,corpus_name[corpus],corpus_error_num(decoder, corpus),result.pattern_num,(unsigned long long)seed,
+                    result.outcome[NE],result.outcome[CE],result.outcome[DUE],result.ns_optimized,result.ns_reference,speedup,result.mismatch_num,last ? "" : ",");
+            else
+                fprintf(fp3,"%s,%s,%d,%lld,%llu,%lld,%lld,%lld,%.3f,%.3f,%.3f,%lld\n",bench_decoder[decoder].name,corpus_name[corpus],corpus_error_num(decoder, corpus),result.pattern_num,(unsigned long long)seed,
+                    result.outcome[NE],result.outcome[CE],result.outcome[DUE],result.ns_optimized,result.ns_reference,speedup,result.mismatch_num);
+        }
+    }
+    if(fp3!=NULL){
+        if(json)
+            fprintf(fp3,"]\n");
+        fclose(fp3);
+    }
+
+    if(undefined_sum>0)
+        printf("%lld AMDCHIPKILL pattern(s) with exactly one zero syndrome checked as DUE (undefined in the original decoder)\n",undefined_sum);
+    if(mismatch_sum>0){
+        fprintf(stderr,"%lld pattern(s) decoded differently from the reference decoders\n",mismatch_sum);
+        return 1;
+    }
+    printf("all patterns decoded as by the reference decoders\n");
+    return 0;
+}
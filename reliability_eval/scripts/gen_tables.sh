@@ -0,0 +1,47 @@
+#!/bin/bash
+# Fault_sim_tables.h (on stdout) : table data of Fault_sim.cpp, compiled in as constexpr data
+#   $1 : GF(2^8) primitive polynomials, one per line (ex) D^8+D^4+D^3+D^2+1)
+#   $2 : OECC H matrix, one row per line (0/1 separated by spaces)
+
+if [ $# -ne 2 ] || [ ! -r "$1" ] || [ ! -r "$2" ]; then
+    echo "usage : $0 <primitive polynomial file> <OECC H matrix file>" >&2
+    exit 1
+fi
+
+echo "// generated by scripts/gen_tables.sh from $1 and $2, do not edit"
+echo
+
+# polynomial without the D^8 term : bit i = coefficient of D^i
+awk '{ gsub(/[ \t\r]/, "") }
+     $0 != "" {
+         value = 0
+         term_num = split($0, term, "+")
+         for(i = 1; i <= term_num; i++){
+             if(term[i] == "1")
+                 value += 1
+             else if(term[i] ~ /^D\^[0-7]$/)
+                 value += 2^substr(term[i], 3)
+             else if(term[i] != "D^8"){
+                 printf "%s:%d: unexpected term %s\n", FILENAME, NR, term[i] > "/dev/stderr"
+                 exit 1
+             }
+         }
+         list = list sprintf("%s0x%02X", (list == "") ? "" : ", ", value)
+     }
+     END { printf "#define GF_PRIMITIVE_POLY_LIST %s\n\n", list }' "$1" || exit 1
+
+# rows and columns are checked against OECC_REDUN_LEN, OECC_H_CW_LEN by static_assert
+awk '{ gsub(/\r/, "") }
+     NF {
+         row_num++
+         column_num = (row_num == 1 || NF == column_num) ? NF : -1
+         row = ""
+         for(i = 1; i <= NF; i++)
+             row = row sprintf("%s%d", (i == 1) ? "" : ",", $i)
+         rows = rows sprintf("    {%s}, \\\n", row)
+     }
+     END {
+         printf "#define H_MATRIX_OECC_ROW_NUM %d\n", row_num
+         printf "#define H_MATRIX_OECC_COLUMN_NUM %d\n", column_num
+         printf "#define H_MATRIX_OECC_ROWS \\\n%s\n", rows
+     }' "$2"
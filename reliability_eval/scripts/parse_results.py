@@ -1,3 +1,4 @@
+import csv
 import os
 import re
 
@@ -11,7 +12,13 @@ FAULT_MAP = {
     5: ["SCE_SBE", "1 chip + 1 bit"],
     6: ["SCE_DBE", "1 chip + 2 bits"],
     7: ["SCE_SCE", "1 chip + 1 chip"],
-    8: ["RANK", "rank"]
+    8: ["RANK", "rank"],
+    9: ["ROWHAMMER", "RowHammer row"]
+}
+
+OECC_MAP = {
+    0: "OECC_OFF",
+    1: "OECC_ON"
 }
 
 RECC_MAP = {
@@ -20,6 +27,7 @@ RECC_MAP = {
     3: "OOC"
 }
 
+oecc_params  = [1] # same lists as run.py
 fault_params = [0, 1, 2, 3, 4, 5, 6, 7, 8]
 recc_params  = [1, 2, 3]
 
@@ -51,39 +59,30 @@ def parse_result_file(filepath):
         
     return results
 
-def main():
-    script_dir = os.path.dirname(os.path.abspath(__file__))
-    os.chdir(script_dir + "/../")
-
-    """Main execution function"""
-    all_results = {}
-
-    # Read files and parse data based on the defined parameters
-    for fault_p in fault_params:
-        fault_info = FAULT_MAP.get(fault_p)
-        if not fault_info:
-            continue
-        
-        fault_filename_str, fault_report_name = fault_info
-        all_results[fault_report_name] = {}
-
-        for recc_p in recc_params:
-            recc_name = RECC_MAP.get(recc_p)
-            if not recc_name:
-                continue
+def parse_sweep_file(filepath):
+    """Reads the CE, DUE, and SDC rates of every configuration from a sweep table (--sweep)."""
+    results = {}
+    with open(filepath, 'r') as f:
+        for row in csv.DictReader(f):
+            results[(row['oecc'], row['fault'], row['recc'])] = {metric: float(row[metric]) for metric in ['CE', 'DUE', 'SDC']}
+    return results
 
-            # File naming convention from C++ code: RECC + "_" + FAULT + ".S"
-            filename = f"{out_dir}/{recc_name}_{fault_filename_str}.S"
-            
-            parsed_data = parse_result_file(filename)
-            all_results[fault_report_name][recc_name] = parsed_data
+def use_sweep_file(sweep_file, result_files):
+    """The sweep table is used unless a single-run result file was written after it."""
+    if not os.path.exists(sweep_file):
+        return False
+    result_times = [os.path.getmtime(filepath) for filepath in result_files if os.path.exists(filepath)]
+    return not result_times or os.path.getmtime(sweep_file) >= max(result_times)
 
-    # --- Print Final Result Table ---
+def print_result_table(all_results, title):
+    """Prints the CE, DUE, and SDC rates of every fault type (rows) and RECC (columns)."""
     recc_names_ordered = [RECC_MAP[key] for key in sorted(RECC_MAP.keys()) if key in recc_params]
     
     header = f"{'Error scenario':<26}"
     for name in recc_names_ordered:
         header += f"{name.replace('_', ' '):>18}"
+    if title:
+        print(title)
     print(header)
     print("=" * (len(header)+3))
 
@@ -101,6 +100,34 @@ def main():
             print(line)
         print("-" * (len(header)+3))
 
+def main():
+    script_dir = os.path.dirname(os.path.abspath(__file__))
+    os.chdir(script_dir + "/../")
+
+    """Main execution function"""
+    # Sweep mode writes one table, single runs write one .S file per configuration
+    # (file naming convention from C++ code: RECC + "_" + FAULT + ".S", the OECC setting is not in the name)
+    result_files = {(fault_p, recc_p): f"{out_dir}/{RECC_MAP[recc_p]}_{FAULT_MAP[fault_p][0]}.S"
+                    for fault_p in fault_params if fault_p in FAULT_MAP for recc_p in recc_params if recc_p in RECC_MAP}
+    sweep_file = f"{out_dir}/sweep.csv"
+    sweep_results = parse_sweep_file(sweep_file) if use_sweep_file(sweep_file, result_files.values()) else None
+
+    # Read files and parse data based on the defined parameters (one table per OECC setting of the sweep)
+    for oecc_p in (oecc_params if sweep_results is not None else [None]):
+        all_results = {}
+        for (fault_p, recc_p), filename in result_files.items():
+            fault_filename_str, fault_report_name = FAULT_MAP[fault_p]
+            recc_name = RECC_MAP[recc_p]
+            if sweep_results is not None:
+                parsed_data = sweep_results.get((OECC_MAP[oecc_p], fault_filename_str, recc_name), {'CE': 0.0, 'DUE': 0.0, 'SDC': 0.0})
+            else:
+                parsed_data = parse_result_file(filename)
+            all_results.setdefault(fault_report_name, {})[recc_name] = parsed_data
+
+        # --- Print Final Result Table ---
+        title = OECC_MAP[oecc_p] if oecc_p is not None and len(oecc_params) > 1 else ""
+        print_result_table(all_results, title)
+
 
 if __name__ == "__main__":
     main()
\ No newline at end of file
@@ -10,17 +10,13 @@ recc  = [1, 2, 3]
 out_dir = "results"
 os.makedirs(f"./{out_dir}", exist_ok=True)
 
-# Launch simulation
+# Launch simulation : one process runs the whole oecc x fault x recc matrix (sweep mode)
+# and balances the configurations across all hardware threads
 print("Running simulations...")
-procs = []
+to_list = lambda params: ",".join(str(param) for param in params)
+p = subprocess.Popen(f"./Fault_sim_start --sweep {to_list(oecc)} {to_list(fault)} {to_list(recc)} --threads 0 {out_dir}/sweep.csv",
+                     shell=True)
 
-for oecc_param in oecc:
-    for fault_param in fault:        
-        for recc_param in recc:
-            procs.append(subprocess.Popen(f"./Fault_sim_start {oecc_param} {fault_param} {recc_param} {out_dir}",
-                                        shell=True))
-
-# Wait for all simulations to finish
-for p in procs:
-    rc = p.wait()
+# Wait for the sweep to finish
+rc = p.wait()
 print()